@@ -0,0 +1,203 @@
+// Maze kernels that work on a whole row of cells at a time, 64 cells to a machine word, instead of looking at each cell
+// and its neighbours one by one. A set bit is a wall, so the spaces in a word are the inverse of it, and the cells to the
+// east and west of every cell in a word are the word shifted by one, with the end bit carried in from the next word.
+
+#include <string.h>				// For memset.
+
+#include "Bitboard.h"			// For the bit grid kernels.
+
+// Get the spaces in 64-bit word w of row y of a grid, a set bit for each space. Bytes are put together in order, so this
+// is the same on any CPU. Anything outside of the grid is wall.
+static uint64_t loadSpaces(const struct bitgrid* g, unsigned int y, unsigned int w)
+{
+	const unsigned char* p;		// First byte of the word.
+	unsigned int n;				// Bytes of the word inside the row.
+	unsigned int words = BITWORDS(g->cols);
+	uint64_t v;					// Walls in the word.
+
+	if ((y >= g->rows) || (w >= words)) { return 0; }
+	p = g->cells + ((size_t)y * g->rowBytes) + (w * 8);
+	n = g->rowBytes - (w * 8);
+	if (n >= 8)
+	{
+		v = (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+			((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+	}
+	else
+	{
+		v = ~(uint64_t)0 << (n * 8);
+		for (unsigned int i = 0; i < n; i++) { v |= (uint64_t)p[i] << (i * 8); }
+	}
+	v = ~v;
+	if ((w == words - 1) && ((g->cols & 63) != 0)) { v &= ((uint64_t)1 << (g->cols & 63)) - 1; }
+	return v;
+}
+
+// Count the set bits in a word.
+static unsigned int countBits(uint64_t v)
+{
+	return (unsigned int)__builtin_popcountll(v);
+}
+
+// Reverse the order of the bits in a word, so filling towards the low bits can be done the same way as towards the high.
+static uint64_t reverseBits(uint64_t v)
+{
+	v = ((v >> 1) & 0x5555555555555555ull) | ((v & 0x5555555555555555ull) << 1);
+	v = ((v >> 2) & 0x3333333333333333ull) | ((v & 0x3333333333333333ull) << 2);
+	v = ((v >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((v & 0x0F0F0F0F0F0F0F0Full) << 4);
+	v = ((v >> 8) & 0x00FF00FF00FF00FFull) | ((v & 0x00FF00FF00FF00FFull) << 8);
+	v = ((v >> 16) & 0x0000FFFF0000FFFFull) | ((v & 0x0000FFFF0000FFFFull) << 16);
+	return (v >> 32) | (v << 32);
+}
+
+// Open the cells from x0 to x1 (inclusive) in a row of a grid, a whole byte at a time.
+void bitOpenRun(unsigned char* row, unsigned int x0, unsigned int x1)
+{
+	unsigned int b0 = x0 >> 3, b1 = x1 >> 3;						// Bytes at each end of the run.
+	unsigned char m0 = (unsigned char)(0xFFu << (x0 & 7));			// Bits from x0 on in its byte.
+	unsigned char m1 = (unsigned char)(0xFFu >> (7 - (x1 & 7)));	// Bits up to x1 in its byte.
+
+	if (b0 == b1)
+	{
+		row[b0] &= (unsigned char)~(m0 & m1);
+		return;
+	}
+	row[b0] &= (unsigned char)~m0;
+	if (b1 > b0 + 1) { memset(row + b0 + 1, 0, b1 - b0 - 1); }
+	row[b1] &= (unsigned char)~m1;
+}
+
+// Set len cells (up to 25) from x0 in a row of a grid to the bits in bits, a set bit for a wall, with one read and one write
+// of the bytes they are in.
+void bitSetRun(unsigned char* row, unsigned int x0, uint32_t bits, unsigned int len)
+{
+	unsigned char* p = row + (x0 >> 3);				// First byte of the run.
+	unsigned int shift = x0 & 7;					// Place of x0 in its byte.
+	unsigned int n = (shift + len + 7) / 8;			// Bytes the run is in.
+	uint32_t mask = ((1u << len) - 1) << shift;		// Bits of the run.
+	uint32_t v = 0;
+
+	for (unsigned int i = 0; i < n; i++) { v |= (uint32_t)p[i] << (i * 8); }
+	v = (v & ~mask) | ((bits << shift) & mask);
+	for (unsigned int i = 0; i < n; i++) { p[i] = (unsigned char)(v >> (i * 8)); }
+}
+
+// Count the spaces in a grid, and the dead ends and junctions among them, 64 cells at a time. The ways on from each cell
+// are added up across the four words of its neighbours with half adders, one sum and one carry bit for each pair.
+unsigned int bitCountWays(const struct bitgrid* g, unsigned int* deadEnds, unsigned int* junctions)
+{
+	unsigned int words = BITWORDS(g->cols);	// Words in each row.
+	unsigned int spaces = 0, ends = 0, joins = 0;
+	uint64_t last, here, next;				// Spaces in the last, this and the next word of the row.
+	uint64_t n, s, e, w;					// Spaces to the north, south, east and west of each cell in the word.
+	uint64_t s1, c1, s2, c2;				// Sum and carry of north and south, then of east and west.
+
+	for (unsigned int y = 0; y < g->rows; y++)
+	{
+		last = 0;
+		here = loadSpaces(g, y, 0);
+		for (unsigned int i = 0; i < words; i++)
+		{
+			next = loadSpaces(g, y, i + 1);
+			n = loadSpaces(g, y - 1, i);
+			s = loadSpaces(g, y + 1, i);
+			e = (here >> 1) | (next << 63);
+			w = (here << 1) | (last >> 63);
+
+			// One way on is an odd count with no carries, three is a carry and a sum, four is both carries.
+			s1 = n ^ s;
+			c1 = n & s;
+			s2 = e ^ w;
+			c2 = e & w;
+			spaces += countBits(here);
+			ends += countBits(here & (s1 ^ s2) & ~(c1 | c2));
+			joins += countBits(here & ((c1 & c2) | (c1 & s2) | (c2 & s1)));
+
+			last = here;
+			here = next;
+		}
+	}
+	*deadEnds = ends;
+	*junctions = joins;
+	return spaces;
+}
+
+// Spread reached cells along the spaces of a word to the walls at each end. Adding the reached cells to the spaces
+// carries each of them up through its run of spaces to the wall at the end, so the bits that change are the cells it
+// reaches. Doing the same to the word reversed reaches the cells going the other way.
+static uint64_t fillWord(uint64_t spaces, uint64_t r)
+{
+	uint64_t m = reverseBits(spaces);	// Spaces reversed.
+
+	r |= ((spaces + r) ^ spaces) & spaces;
+	r = reverseBits(r);
+	r |= ((m + r) ^ m) & m;
+	return reverseBits(r);
+}
+
+// Flood fill from a space a word at a time. A word is filled from the reached cells next to it in the words above and
+// below and the end bits of the words either side, then spread along its spaces. Words wait on a stack while they need
+// filling, and a word is put back on whenever a neighbour reaches a cell next to one of its spaces.
+unsigned int bitFloodFill(const struct bitgrid* g, unsigned int x, unsigned int y, uint64_t* reached, unsigned int* work)
+{
+	unsigned int words = BITWORDS(g->cols);		// Words in each row.
+	size_t total = (size_t)g->rows * words;		// Words in the grid.
+	unsigned int* stack = work;					// Words waiting to be filled, as y * words + word.
+	unsigned int* waiting = work + total;		// Whether each word is on the stack.
+	unsigned int top = 0;						// Words on the stack.
+	unsigned int count = 0;						// Cells reached.
+	unsigned int c, wy, wi;						// Word, its row and its place in the row.
+	uint64_t m, r, add;							// Spaces, reached cells and cells added in the word.
+	uint64_t first = (uint64_t)1 << (x & 63);	// Cell to start from, added when its word comes off the stack.
+
+	memset(reached, 0, total * sizeof(uint64_t));
+	if ((x >= g->cols) || (y >= g->rows) || (((loadSpaces(g, y, x / 64) >> (x & 63)) & 1) == 0)) { return 0; }
+	memset(waiting, 0, total * sizeof(unsigned int));
+	c = (y * words) + (x / 64);
+	stack[top++] = c;
+	waiting[c] = 1;
+
+	while (top > 0)
+	{
+		c = stack[--top];
+		waiting[c] = 0;
+		wy = c / words;
+		wi = c % words;
+		m = loadSpaces(g, wy, wi);
+		r = reached[c] | first;
+		first = 0;
+		if (wy > 0) { r |= reached[c - words] & m; }
+		if (wy + 1 < g->rows) { r |= reached[c + words] & m; }
+		if (wi > 0) { r |= (reached[c - 1] >> 63) & m; }
+		if (wi + 1 < words) { r |= (reached[c + 1] << 63) & m; }
+		r = fillWord(m, r);
+		add = r & ~reached[c];
+		if (add == 0) { continue; }
+		reached[c] = r;
+
+		// Put back the words next to any cells added that lead on to a space not reached yet.
+		if ((wy > 0) && (waiting[c - words] == 0) && ((add & loadSpaces(g, wy - 1, wi) & ~reached[c - words]) != 0))
+		{
+			stack[top++] = c - words;
+			waiting[c - words] = 1;
+		}
+		if ((wy + 1 < g->rows) && (waiting[c + words] == 0) && ((add & loadSpaces(g, wy + 1, wi) & ~reached[c + words]) != 0))
+		{
+			stack[top++] = c + words;
+			waiting[c + words] = 1;
+		}
+		if ((wi > 0) && (waiting[c - 1] == 0) && ((add & 1) != 0))
+		{
+			stack[top++] = c - 1;
+			waiting[c - 1] = 1;
+		}
+		if ((wi + 1 < words) && (waiting[c + 1] == 0) && ((add >> 63) != 0))
+		{
+			stack[top++] = c + 1;
+			waiting[c + 1] = 1;
+		}
+	}
+
+	for (size_t i = 0; i < total; i++) { count += countBits(reached[i]); }
+	return count;
+}
@@ -0,0 +1,33 @@
+#pragma once
+// Maze kernels that work on a whole row of cells at a time, 64 cells to a machine word, rather than one cell at a time.
+
+#include <stdint.h>				// For 64-bit words.
+
+// A maze held as one bit for each cell, set for a wall. Cell x of a row is bit x & 7 of byte x / 8, the same as the mazes
+// and the .lab pack, so the bytes read the same as words on any CPU. Rows may be any number of bytes, a multiple of 8
+// is fastest.
+struct bitgrid
+{
+	unsigned char* cells;		// Bits for the cells, row after row.
+	unsigned int cols;			// Cells along each row.
+	unsigned int rows;			// Rows of cells.
+	unsigned int rowBytes;		// Bytes from one row to the next.
+};
+
+#define BITWORDS(cols) (((cols) + 63) / 64)		// 64-bit words for a row of cols cells.
+
+// Open the cells from x0 to x1 (inclusive) in a row of a grid, a whole byte at a time.
+extern void bitOpenRun(unsigned char* row, unsigned int x0, unsigned int x1);
+
+// Set len cells (up to 25) from x0 in a row of a grid to the low bits of bits, a set bit for a wall.
+extern void bitSetRun(unsigned char* row, unsigned int x0, uint32_t bits, unsigned int len);
+
+// Count the spaces in a grid, and the dead ends (one way on) and junctions (three or more ways on) among them.
+// Cells outside the grid count as walls. Returns the number of spaces.
+extern unsigned int bitCountWays(const struct bitgrid* g, unsigned int* deadEnds, unsigned int* junctions);
+
+// Find every space that can be reached from the space at x, y. reached needs rows * BITWORDS(cols) words, and gets bit
+// x % 64 of word (y * BITWORDS(cols)) + (x / 64) set for each space reached. work needs 2 * rows * BITWORDS(cols)
+// unsigned ints.
+// Returns the number of spaces reached, 0 if x, y isn't a space.
+extern unsigned int bitFloodFill(const struct bitgrid* g, unsigned int x, unsigned int y, uint64_t* reached, unsigned int* work);
@@ -0,0 +1,54 @@
+#pragma once
+// Stand-ins for the few Wii U calls the game states in main.c use, so the game can run headless on a PC with no screen,
+// gamepad or real time. The gamepad and the clock are provided by the program driving the game (tools/headless.c).
+
+#include <stdint.h>				// For exact sized integers.
+#include <stdbool.h>			// For booleans.
+
+// Gamepad buttons, the same values as the Wii U so scripts mean the same thing on both.
+#define VPAD_BUTTON_A					0x00008000
+#define VPAD_BUTTON_B					0x00004000
+#define VPAD_BUTTON_X					0x00002000
+#define VPAD_BUTTON_Y					0x00001000
+#define VPAD_BUTTON_LEFT				0x00000800
+#define VPAD_BUTTON_RIGHT				0x00000400
+#define VPAD_BUTTON_UP					0x00000200
+#define VPAD_BUTTON_DOWN				0x00000100
+#define VPAD_BUTTON_ZL					0x00000080
+#define VPAD_BUTTON_ZR					0x00000040
+#define VPAD_BUTTON_R					0x00000010
+#define VPAD_STICK_L_EMULATION_LEFT		0x40000000
+#define VPAD_STICK_L_EMULATION_RIGHT	0x20000000
+#define VPAD_STICK_L_EMULATION_UP		0x10000000
+#define VPAD_STICK_L_EMULATION_DOWN		0x08000000
+
+typedef enum { VPAD_CHAN_0 = 0 } VPADChan;
+typedef enum { VPAD_READ_SUCCESS = 0, VPAD_READ_NO_SAMPLES = -1 } VPADReadError;
+
+// The part of the gamepad status the game uses.
+typedef struct
+{
+	uint32_t hold;				// Buttons held down.
+	uint32_t trigger;			// Buttons pressed since the last read.
+	uint32_t release;			// Buttons let go since the last read.
+} VPADStatus;
+
+typedef int64_t OSTime;			// Time in ticks, a tick is a millisecond when headless.
+
+#define OSMillisecondsToTicks(ms) ((OSTime)(ms))
+#define OSTicksToMilliseconds(ticks) ((OSTime)(ticks))
+
+// Read the gamepad, from the script or the solver driving the game.
+extern int32_t VPADRead(VPADChan chan, VPADStatus* buffers, uint32_t count, VPADReadError* error);
+
+// Get the time, from the clock the driver moves on a frame at a time rather than the real time.
+extern OSTime OSGetTime(void);
+
+// The game states in main.c, for the driver to run. The driver calls the one for getGameState each tick.
+extern void doState0(void);		// Start screen.
+extern void doState1(void);		// Playing a level.
+extern void doState2(void);		// New level screen.
+extern void doState3(void);		// End of game screen.
+extern unsigned int getGameState(void);	// Return the game state, 0 start, 1 playing, 2 new level, 3 end.
+extern void suspendPlay(void);	// Save the level being played for the next launch, as the game does when it exits.
+extern void resumePlay(void);	// Carry on the level saved, as the game does at launch.
@@ -0,0 +1,184 @@
+// Gamepad input for the game. On the Wii U a thread polls the gamepad at a fixed rate, reading every sample it has
+// taken, and puts each change of the buttons in a queue with the time it was seen. Input is then sampled the same
+// however long a frame takes to draw. Each frame the game states drain the queue, and each direction press is put in
+// a ring buffer of moves. The game takes the moves from the buffer as each move's animation finishes, so a quick press
+// made part way through an animation is made next instead of being missed.
+//
+// The queue has one thread putting events in and one taking them out, so it needs no locks. Each side only writes its
+// own index, and the release and acquire on the indexes make sure an event is written before the other side sees it.
+// Without the thread (headless on a PC) the gamepad is read once a frame when the queue is drained.
+
+#include <string.h>						// For memset.
+#include <stdatomic.h>					// For the queue indexes shared with the polling thread.
+
+#ifdef __WIIU__
+#include <coreinit/thread.h>			// For sleeping between polls.
+#include <coreinit/time.h>				// For the time of each poll.
+#include <vpad/input.h>					// For the game pad inputs.
+#else
+#include <unistd.h>						// For sleeping between polls.
+#include "Headless.h"					// For the gamepad and time when running headless on a PC.
+#endif
+
+#include "Input.h"						// For the input functions.
+#include "Threads.h"					// For the polling thread.
+
+// A change of the buttons seen by the polling thread.
+struct inputevent
+{
+	uint32_t pressed;					// Buttons pressed since the last sample.
+	uint32_t released;					// Buttons let go since the last sample.
+	OSTime time;						// Time the gamepad was polled.
+};
+
+static struct inputevent events[INPUTEVENTS];	// Changes of the buttons, from the polling thread to the game.
+static atomic_uint eventHead = 0;		// Next event for the game to take, only written by the game.
+static atomic_uint eventTail = 0;		// Where the next event goes, only written by the polling thread.
+static atomic_uint heldNow = 0;			// Buttons held in the latest sample, from the polling thread.
+static atomic_bool polling = false;		// Set while the polling thread should keep running.
+static struct thread poller;			// Thread polling the gamepad.
+static uint32_t lastHold = 0;			// Buttons held in the last sample, only used by whoever polls.
+
+static struct moveevent queue[INPUTQUEUE];	// Moves waiting, oldest at head.
+static unsigned int head = 0;			// Next move to take, counts up and is masked to the buffer.
+static unsigned int tail = 0;			// Where the next move pressed goes.
+static uint32_t held = 0;				// Buttons held at the start of this frame.
+static uint32_t pressed = 0;			// Buttons pressed since the last frame.
+
+// Get the move for the direction buttons given, 0 if there isn't one. Later checks win, as they always have.
+static char buttonMove(uint32_t buttons)
+{
+	char move = 0;
+
+	if (buttons & (VPAD_BUTTON_UP | VPAD_STICK_L_EMULATION_UP)) { move = 'f'; }
+	if (buttons & (VPAD_BUTTON_LEFT | VPAD_STICK_L_EMULATION_LEFT)) { move = 'l'; }
+	if (buttons & (VPAD_BUTTON_RIGHT | VPAD_STICK_L_EMULATION_RIGHT)) { move = 'r'; }
+	return move;
+}
+
+// Read the samples the gamepad has taken since the last read, newest first, and go through them oldest first. Each
+// change of the buttons is put in the queue, or dropped if the game has let the queue fill up.
+static void pollInput(void)
+{
+	VPADStatus samples[INPUTSAMPLES];	// Samples read.
+	VPADReadError error;				// Error from gamepad.
+	int32_t count;						// Samples read.
+	OSTime now = OSGetTime();			// Time of the poll.
+	unsigned int t;						// Where the next event goes.
+	uint32_t hold;						// Buttons held in a sample.
+
+	memset(samples, 0, sizeof(samples));
+	count = VPADRead(VPAD_CHAN_0, samples, INPUTSAMPLES, &error);
+	if ((error != VPAD_READ_SUCCESS) || (count <= 0)) { return; }
+	if (count > INPUTSAMPLES) { count = INPUTSAMPLES; }
+
+	for (int32_t i = count - 1; i >= 0; i--)
+	{
+		hold = samples[i].hold;
+		if (hold == lastHold) { continue; }
+
+		t = atomic_load_explicit(&eventTail, memory_order_relaxed);
+		if ((t - atomic_load_explicit(&eventHead, memory_order_acquire)) < INPUTEVENTS)
+		{
+			events[t & (INPUTEVENTS - 1)].pressed = hold & ~lastHold;
+			events[t & (INPUTEVENTS - 1)].released = lastHold & ~hold;
+			events[t & (INPUTEVENTS - 1)].time = now;
+			atomic_store_explicit(&eventTail, t + 1, memory_order_release);
+		}
+		lastHold = hold;
+	}
+	atomic_store_explicit(&heldNow, lastHold, memory_order_release);
+}
+
+// Polling thread, reads the gamepad every INPUTPOLLMS until stopInput.
+static void pollThread(void* arg)
+{
+	(void)arg;
+	while (atomic_load(&polling) == true)
+	{
+		pollInput();
+#ifdef __WIIU__
+		OSSleepTicks(OSMillisecondsToTicks(INPUTPOLLMS));
+#else
+		usleep(INPUTPOLLMS * 1000);
+#endif
+	}
+}
+
+// Start the thread polling the gamepad. If it can't be started the gamepad is read once a frame instead.
+void startInput()
+{
+	if (atomic_load(&polling) == true) { return; }
+	atomic_store(&polling, true);
+	if (startThread(&poller, pollThread, NULL, INPUTCORE) == false) { atomic_store(&polling, false); }
+}
+
+// Stop the polling thread, call before exiting.
+void stopInput()
+{
+	if (atomic_load(&polling) == false) { return; }
+	atomic_store(&polling, false);
+	joinThread(&poller);
+}
+
+// Take the changes of the buttons since the last frame from the queue, call once a frame in every game state. Each
+// direction pressed is added to the moves waiting, dropped if the buffer is full.
+void readInput()
+{
+	unsigned int h;						// Next event to take.
+	struct inputevent* ev;				// Event taken.
+	char move;
+
+	if (atomic_load(&polling) == false) { pollInput(); }
+
+	pressed = 0;
+	h = atomic_load_explicit(&eventHead, memory_order_relaxed);
+	while (h != atomic_load_explicit(&eventTail, memory_order_acquire))
+	{
+		ev = &events[h & (INPUTEVENTS - 1)];
+		pressed |= ev->pressed;
+		move = buttonMove(ev->pressed);
+		if ((move != 0) && ((tail - head) < INPUTQUEUE))
+		{
+			queue[tail & (INPUTQUEUE - 1)].move = move;
+			queue[tail & (INPUTQUEUE - 1)].time = ev->time;
+			tail++;
+		}
+		h++;
+		atomic_store_explicit(&eventHead, h, memory_order_release);
+	}
+	held = atomic_load_explicit(&heldNow, memory_order_acquire);
+}
+
+// Take the oldest move waiting. Return false if there isn't one.
+bool getMoveEvent(struct moveevent* e)
+{
+	if (head == tail) { return false; }
+	*e = queue[head & (INPUTQUEUE - 1)];
+	head++;
+	return true;
+}
+
+// Return the move for the direction held now, so holding a direction keeps the player moving.
+char getHeldMove()
+{
+	return buttonMove(held);
+}
+
+// Return the buttons held now.
+uint32_t getInputHeld()
+{
+	return held;
+}
+
+// Return the buttons pressed since the last frame.
+uint32_t getInputPressed()
+{
+	return pressed;
+}
+
+// Forget the moves waiting, so moves pressed for one level aren't made in the next.
+void clearInput()
+{
+	head = tail;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+// Gamepad input for the game, polled on its own thread so that input doesn't depend on how long a frame takes, and no
+// presses are lost while a move is being animated.
+
+#include <stdbool.h>					// For booleans.
+#include <stdint.h>						// For exact sized integers.
+
+#define INPUTSAMPLES 16					// Most gamepad samples read each poll, as many as the gamepad keeps.
+#define INPUTEVENTS  64					// Changes of the buttons kept for the game to take, a power of 2.
+#define INPUTQUEUE   8					// Moves kept waiting for the animation to finish, a power of 2.
+#define INPUTPOLLMS  4					// Time between polls of the gamepad in milliseconds.
+#define INPUTCORE    0					// Core the gamepad is polled on, the game runs on core 1 and mazes are made on 2.
+
+// A move pressed on the gamepad, waiting to be made.
+struct moveevent
+{
+	char move;							// 'f' forward, 'l' turn left or 'r' turn right.
+	int64_t time;						// Time the press was seen, in OSTime ticks.
+};
+
+void startInput(void);					// Start polling the gamepad on its own thread.
+void stopInput(void);					// Stop polling the gamepad, call before exiting.
+
+void readInput(void);					// Take the button changes since the last frame, call once a frame in every game state.
+bool getMoveEvent(struct moveevent* e);	// Take the oldest move pressed, return false if there isn't one.
+char getHeldMove(void);					// Return the move for the direction held now, 0 if none, so holding keeps moving.
+uint32_t getInputHeld(void);			// Return the buttons held now.
+uint32_t getInputPressed(void);			// Return the buttons pressed since the last frame.
+void clearInput(void);					// Forget the moves waiting, when a level ends.
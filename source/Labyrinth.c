@@ -1,464 +1,2967 @@
-
-// Maze functions to create random mazes then control the movement of the player through the maze.
-// Including APIs to get the current maze view to support graphics display.
-
-#include <stdlib.h>						// For rand() random numbers.
-#include <stdio.h>						// For sprintf.
-#include <stdbool.h>					// for booleans.
-#include <unistd.h>						// For getcwd.
-#include <string.h>						// For strcat and maybe other functions.
-
-#include "Labyrinth.h"					// Header for maze access functions.
-#include "Sounds.h"						// For sound effects.
-
-#define MAZEADD	   4					// Added to maze size, so lower level mazes aren't too small.
-#define MAZEBORDER 1					// Border around the maze to ensure all side corridors cannot run out of the maze.
-#define BLKSIZE    3					// Size of maze building blocks.
-
-										// Absolute maximum for maze game array surrounded by border.
-#define MMAX	   (((MAXLEVEL + MAZEADD) * BLKSIZE) + MAZEBORDER + MAZEBORDER)
-
-static char   gameMaze[MMAX][MMAX];		// Array containing the maze to be solved.
-static unsigned int Msize;				// Maze size for the current maze. 
-
-// These are initialised to be on the safe side but are set up in the game.
-static unsigned int playerX = 2;		// Player X position in mazeArray
-static unsigned int playerY = 2;		// Player Y postiion in mazeArray
-static unsigned int playerD = 4;		// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left)
-static unsigned int level = 0;			// Game Level
-
-// The four 3-way junction building blocks that random mazes are assembled from:
-//  1    2    3    4
-// # #  # #  ###  # #
-//      #           #
-// ###  # #  # #  # #
-//
-static char blk1[BLKSIZE][BLKSIZE] = { { '#', ' ', '#' }, { ' ', ' ', ' ' }, { '#', '#', '#' } };
-static char blk2[BLKSIZE][BLKSIZE] = { { '#', ' ', '#' }, { '#', ' ', ' ' }, { '#', ' ', '#' } };
-static char blk3[BLKSIZE][BLKSIZE] = { { '#', '#', '#' }, { ' ', ' ', ' ' }, { '#', ' ', '#' } };
-static char blk4[BLKSIZE][BLKSIZE] = { { '#', ' ', '#' }, { ' ', ' ', '#' }, { '#', ' ', '#' } };
-
-// Process to show a 2D representation of the full maze to aid program development on PC.
-void twoDdisplay() 
-{
-	// Display the Maze array contents
-	for (unsigned int y = 0; y < Msize; y++) 
-	{
-		for (unsigned int x = 0; x < Msize; x++) 
-		{
-			// Display the maze, but also show where the player is in the maze.
-			// Note the array is vertical index first.
-			if ((playerX == x) && (playerY == y)) 
-			{ 
-				// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left)
-				switch (playerD)
-				{
-					case 1:  { printf("^"); break; }
-					case 2:  { printf(">"); break; }
-					case 3:  { printf("_"); break; }
-					default: { printf("<"); break; }
-				}
-			}
-			else								  
-			{ 
-				printf("%c", gameMaze[y][x]); 
-			}
-		}
-		printf("\n");
-	}
-	printf("\n");
-}
-
-// Accessor to get view along the corridor for the player in the direction they are facing.
-// f is forward 0 to 8 along the corridor.
-// s is side -1 for left side, 0 for along corridor, and 1 for right side.
-char get3DView(int f, int s)
-{
-	unsigned int xi = 0;	// Working indices.
-	unsigned int yi = 0;
-
-	// If the view requested is outside of the valid range for looking along a corridor return a block.
-	if ((f < 0) || (f > 8) || (s < -1) || (s > 1))
-	{
-		return '#';
-	}
-
-	// The view to be returned depends on which direction the player is facing.
-	switch (playerD)
-	{
-		case 1: // North
-		{
-			// Working index is the offset from the current player position.
-			xi = (int)playerX + s;
-			yi = (int)playerY - f;
-			break;
-		}
-		case 2:	// East
-		{
-			xi = (int)playerX + f;
-			yi = (int)playerY + s;
-			break;
-		}
-		case 3:	// South
-		{
-			xi = (int)playerX - s;
-			yi = (int)playerY + f;
-			break;
-		}
-		default:	// West
-		{
-			xi = (int)playerX - f;
-			yi = (int)playerY - s;
-			break;
-		}
-	}
-
-	// If the player position is inside the maze find the correct character.
-	if ((xi >= 0) && (xi < Msize) && (yi >= 0) && (yi < Msize))
-	{
-		// Return the character within the maze for the requested part of the corridor view.
-		return gameMaze[yi][xi];
-	}
-	// For anything that is out of range report it as a block.
-	return '#';
-}
-
-// Accessor to get any character from the maze including showing the player position and direction.
-// This can be used to have a player aid in the Wii U game and helps with the PC development of the game.
-char get2DView(int x, int y)
-{
-	unsigned int xi, yi;	// Working indices.
-
-	// Working index is the offset from the current player position.
-	xi = (int)playerX + x;
-	yi = (int)playerY + y;
-
-	// If the player position is inside the maze find the correct character.
-	if ((xi >= 0) && (xi < Msize) && (yi >= 0) && (yi < Msize))
-	{
-		// If the indices are the player position, show the player direction.
-		if ((y == 0) && (x == 0))
-		{
-			// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left)
-			// ASCII characters are used in the PC version. Really these need to be arrows.
-			// On the Wii U a custom character set is used, so the ASCII characters actually display as arrows.
-			switch (playerD)
-			{
-			case 1:  { return '^'; }
-			case 2:  { return '>'; }
-			case 3:  { return '_'; }	// Best ASCII character I can do for down.
-			default: { return '<'; }
-			}
-		}
-		else
-		{
-			// Return the character for the position within the maze requested.
-			return gameMaze[yi][xi];
-		}
-	}
-	// For anything that is out of range report it as a block.
-	return '#';
-}
-
-// Move l for turn left, r for turn right and f for forward.
-// Return 0 if move was not possible, 1 if move was performed and 2 if end of level.
-unsigned int movePlayer(char move)
-{
-	// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left)
-	// Turn left.
-	if ((move == 'l') || (move == 'L'))
-	{
-		playerD--;
-		if (playerD < 1) { playerD = 4; }
-		putsoundSel(TURN);
-		return 1;
-	}
-	// Turn right.
-	if ((move == 'r') || (move == 'R'))
-	{
-		playerD++;
-		if (playerD > 4) { playerD = 1; }
-		putsoundSel(TURN);
-		return 1;
-	}
-
-	// Moving forward depends on direction.
-	if ((move == 'f') || (move == 'F'))
-	{
-		//1=North(up)
-		if ((playerD == 1) && (gameMaze[playerY - 1][playerX] == ' '))
-		{
-			playerY--;
-			putsoundSel(MOVE);
-			return 1;
-		}
-		//2=East(right)
-		if ((playerD == 2) && (gameMaze[playerY][playerX + 1] == ' '))
-		{
-			playerX++;
-			putsoundSel(MOVE);
-			return 1;
-		}
-		//3=South(down)
-		if ((playerD == 3) && (gameMaze[playerY + 1][playerX] == ' '))
-		{
-			playerY++;
-			putsoundSel(MOVE);
-			return 1;
-		}
-		//4=West(left)
-		if ((playerD == 4) && (gameMaze[playerY][playerX - 1] == ' '))
-		{
-			playerX--;
-			putsoundSel(MOVE);
-			return 1;
-		}
-		// Check to see if the exit is found.
-		if (((playerD == 1) && (gameMaze[playerY - 1][playerX] == 'E')) ||
-			((playerD == 2) && (gameMaze[playerY][playerX + 1] == 'E')) ||
-			((playerD == 3) && (gameMaze[playerY + 1][playerX] == 'E')) ||
-			((playerD == 4) && (gameMaze[playerY][playerX - 1] == 'E')))
-		{
-			// Increment the level as the current maze is complete
-			level++;
-			if (level > MAXLEVEL) { level = MAXLEVEL; }
-
-			// Overwrite the old data file with the new level, then return 2 to indicate the level is complete.
-			writeLevel(level);
-			putsoundSel(WIN);
-			return 2;
-		}
-	}
-	return 0;	// Move did not work.
-}
-
-// Return the current level to the game so that it can be displayed.
-unsigned int getLevel()
-{
-	return level;
-}
-
-// Write the level to the data file, return false if this fails.
-bool writeLevel(unsigned int newLevel)
-{
-	FILE* outFile;
-	char fileName[1000];
-
-	// Get the current working directory to find where connect is stored to update the game level.
-	getcwd(fileName, sizeof(fileName));
-	strcat(fileName, "/wiiu/apps/Labyrinth/level.txt");
-
-	// If the level is less than 1 set it to 1.
-	// If the level is above MAXLEVEL set to MAXLEVEL.
-	level = newLevel;
-	if (level < 1) { level = 1; }
-	if (level > MAXLEVEL) { level = MAXLEVEL; }
-
-	// Open the file, if the write to the file works return true.
-	outFile = fopen(fileName, "wt");
-	if (outFile != NULL)
-	{
-		fprintf(outFile, "%d \n", level);
-		// To aid development and diagnostics, the names of the variable is also output to the text file.
-		fprintf(outFile, "level \n");
-		fclose(outFile);
-		return true;
-	}
-	return false;	// If opening the file failed.
-}
-
-// Read the current level from the data file, if file not available then create one at level 1.
-unsigned int readLevel()
-{
-	FILE* inFile;
-	char fileName[1000];
-
-	// Get the current working directory to find where connect is stored so that the weightings go with the game.
-	getcwd(fileName, sizeof(fileName));
-	strcat(fileName, "/wiiu/apps/Labyrinth/level.txt");
-
-	// If the file is found, open it and get the current level.
-	inFile = fopen(fileName, "rt");
-	if (inFile != NULL)
-	{
-		fscanf(inFile, "%d \n", &level);
-		fclose(inFile);
-
-		// Limit any value read to a valid range, just in case.
-		if (level < 1) { level = 1; }
-		if (level > MAXLEVEL) { level = MAXLEVEL; }
-		return level;
-	}
-	else
-	{
-		// If the file isn't there create it.
-		writeLevel(1);
-	}
-	// Return the starting level if there was no file.
-	return 1;
-}
-
-// Process to generate the Maze, size (and therefore difficulty) is set by the current game level.
-void generateMaze() 
-{
-	unsigned int sel;	// Variable used for random numbers when constructing the maze.
-
-	// The readLevel function ensures that the level is valid and less the MAXLEVEL;
-	level = readLevel();
-
-	// Set the maze size based on the level.
-	Msize = ((level + MAZEADD) * BLKSIZE) + MAZEBORDER + MAZEBORDER;
-
-	// Fill entire maze array with '#'s. Including all the area not currently used for the level.
-	for (unsigned int y = 0; y < MMAX; y++)
-	{
-		for (unsigned int x = 0; x < MMAX; x++)
-		{
-			gameMaze[y][x] = '#';
-		}
-	}
-
-	// Pick a random 3-way building block and put it in the top left corner of the maze.
-	sel = rand() % 4;
-	for (unsigned int y = 0; y < BLKSIZE; y++)
-	{
-		for (unsigned int x = 0; x < BLKSIZE; x++)
-		{
-			switch (sel)
-			{
-				case 0:  { gameMaze[MAZEBORDER + y][MAZEBORDER + x] = blk1[y][x]; break; }
-				case 1:  { gameMaze[MAZEBORDER + y][MAZEBORDER + x] = blk2[y][x]; break; }
-				case 2:  { gameMaze[MAZEBORDER + y][MAZEBORDER + x] = blk3[y][x]; break; }
-				default: { gameMaze[MAZEBORDER + y][MAZEBORDER + x] = blk4[y][x]; break; }
-			}
-		}
-	}
-
-// The maze is built from left to right along rows and then down. Each time looking for unused blocks with open corridor
-// connections that can be extended. This approach is repeated several times. It is likely on the first pass or two, there 
-// will be blocks that were not used as there was no connecting corridor. Multiple passes allows that these blocks are also 
-// used. Repeating by the level of the maze should always be enough to fill the gaps, if a few gaps are left it doesn't 
-// matter, it will just make the maze a bit more difficult as they are likely fewer crossover points.
-	for (unsigned int a = 0; a < (level + MAZEADD); a++)
-	{
-		// Loop through all of the maze building blocks to find blocks that have not yet been used.
-		// The offset of border and blksize is to inspect the middle of the building block.
-		// If it has not yet been used it will be '#' rather than a space.
-		for (unsigned int y = MAZEBORDER + (BLKSIZE / 2); y < Msize; y = y + BLKSIZE)
-		{
-			for (unsigned int x = MAZEBORDER + (BLKSIZE / 2); x < Msize; x = x + BLKSIZE)
-			{
-				// If a building block that has not yet been used is found. Then see if it connects to an adjacent block.
-				if (gameMaze[y][x] == '#')
-				{
-					// In each case one of three building blocks will be suitable, selected randomly.
-					sel = rand() % 3;
-					// If the connection is west then can only use blks 1, 3, 4.
-					if (gameMaze[y][x - 2] == ' ')
-					{
-						for (unsigned int yi = 0; yi < BLKSIZE; yi++)
-						{
-							for (unsigned int xi = 0; xi < BLKSIZE; xi++)
-							{
-								switch (sel)
-								{
-								case 0:  { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk1[yi][xi]; break; }
-								case 1:  { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk3[yi][xi]; break; }
-								default: { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk4[yi][xi]; break; }
-								}
-							}
-						}
-					}
-					// If the connection is east then can only use blks 1, 2, 3.
-					if (gameMaze[y][x + 2] == ' ')
-					{
-						for (unsigned int yi = 0; yi < BLKSIZE; yi++)
-						{
-							for (unsigned int xi = 0; xi < BLKSIZE; xi++)
-							{
-								switch (sel)
-								{
-								case 0:  { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk1[yi][xi]; break; }
-								case 1:  { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk2[yi][xi]; break; }
-								default: { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk3[yi][xi]; break; }
-								}
-							}
-						}
-					}
-					// If the connection is north then can only use blks 1, 2, 4.
-					if (gameMaze[y - 2][x] == ' ')
-					{
-						for (unsigned int yi = 0; yi < BLKSIZE; yi++)
-						{
-							for (unsigned int xi = 0; xi < BLKSIZE; xi++)
-							{
-								switch (sel)
-								{
-								case 0:  { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk1[yi][xi]; break; }
-								case 1:  { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk2[yi][xi]; break; }
-								default: { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk4[yi][xi]; break; }
-								}
-							}
-						}
-					}
-					// If the connection is south then can only use blks 2, 3, 4.
-					if (gameMaze[y + 2][x] == ' ')
-					{
-						for (unsigned int yi = 0; yi < BLKSIZE; yi++)
-						{
-							for (unsigned int xi = 0; xi < BLKSIZE; xi++)
-							{
-								switch (sel)
-								{
-								case 0:  { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk2[yi][xi]; break; }
-								case 1:  { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk3[yi][xi]; break; }
-								default: { gameMaze[y - MAZEBORDER + yi][x - MAZEBORDER + xi] = blk4[yi][xi]; break; }
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-	}
-
-	// Set the player starting position to the top left of the maze and facing east.
-	playerX = MAZEBORDER + (BLKSIZE / 2);
-	playerY = MAZEBORDER + (BLKSIZE / 2);
-	playerD = 2;
-
-	// Position the exit searching in from the bottom right corner of the maze, until a space is found.
-	// Find a position that is a side turning so that the exit isn't visible down a corridor.
-	// Return once suitable exit added to maze, to avoid having more than one exit.
-	for (unsigned int y = Msize - 1; y > 1; y--)
-	{
-		for (unsigned int x = Msize - 1; x > 1; x--)
-		{
-			// Surrounding blocks are checked to ensure that it is a side corridor and not visible along the length of a corridor.
-			// South side corridor
-			if ((gameMaze[y][x] == ' ') && (gameMaze[y][x - 1] == '#') && (gameMaze[y][x + 1] == '#') && (gameMaze[y + 1][x] == '#') && (gameMaze[y - 2][x] == '#'))
-			{
-				gameMaze[y][x] = 'E';
-				return;
-			}
-			// North side corridor 
-			if ((gameMaze[y][x] == ' ') && (gameMaze[y][x - 1] == '#') && (gameMaze[y][x + 1] == '#') && (gameMaze[y - 1][x] == '#') && (gameMaze[y + 2][x] == '#'))
-			{
-				gameMaze[y][x] = 'E';
-				return;
-			}
-			// East side corridor
-			if ((gameMaze[y][x] == ' ') && (gameMaze[y - 1][x] == '#') && (gameMaze[y + 1][x] == '#') && (gameMaze[y][x + 1] == '#') && (gameMaze[y][x - 2] == '#'))
-			{
-				gameMaze[y][x] = 'E';
-				return;
-			}
-			// West side corridor
-			if ((gameMaze[y][x] == ' ') && (gameMaze[y - 1][x] == '#') && (gameMaze[y + 1][x] == '#') && (gameMaze[y][x + 2] == '#') && (gameMaze[y][x - 1] == '#'))
-			{
-				gameMaze[y][x] = 'E';
-				return;
-			}
-		}
-	}
-}
+
+// Maze functions to create random mazes then control the movement of the player through the maze.
+// Including APIs to get the current maze view to support graphics display.
+
+#include <stdlib.h>						// For realloc and calloc.
+#include <stdint.h>						// For exact sized integers for the random numbers.
+#include <stdio.h>						// For sprintf.
+#include <stdbool.h>					// for booleans.
+#include <string.h>						// For strcat and maybe other functions.
+#include <limits.h>						// For UINT_MAX.
+#include <float.h>						// For FLT_MAX.
+#ifdef __WIIU__
+#include <malloc.h>						// For memalign.
+#else
+#include <fcntl.h>						// For open.
+#include <unistd.h>						// For close.
+#include <sys/mman.h>					// For mmap.
+#include <sys/stat.h>					// For fstat.
+#endif
+
+#include "Labyrinth.h"					// Header for maze access functions.
+#include "Sounds.h"						// For sound effects.
+#include "Threads.h"					// For making the next maze in the background.
+#include "Bitboard.h"					// For working on whole rows of the maze at once.
+#include "Storage.h"					// For the level file and the snapshot.
+
+#define MAZEADD	   4					// Added to maze size, so lower level mazes aren't too small.
+#define MAZEBORDER 1					// Border around the maze to ensure all side corridors cannot run out of the maze.
+#define BLKSIZE    3					// Size of maze building blocks.
+#define ROWBYTES(cells) ((((cells) + 63) / 64) * 8)	// Bytes for a row of cells, whole 64-bit words for the Bitboard kernels.
+#define WORKERCORE 2					// Core the next maze is made on, the game itself runs on core 1.
+#define LEVELFILE  "level.txt"			// Level file, in the game's directory.
+#define TARGETFIRST 2.5f				// Difficulty wanted at level 1, when picking between candidate mazes.
+#define TARGETLAST  6.0f				// Difficulty wanted at MAXLEVEL and above.
+
+// Random numbers for making mazes come from xoshiro128**, rather than rand(). It only uses 32-bit sums, so a seed makes
+// exactly the same maze on the Wii U and on a PC, and each user keeps its own state so nothing else can change the sequence.
+struct rng
+{
+	uint32_t s[4];						// Generator state, never all zero.
+};
+
+// The maze is bit-packed, a set bit is a block '#' and a clear bit is a space ' '. This is 8 times smaller than
+// storing a character per cell, so a whole row of a level 25 maze fits in a cache line. There is only ever one exit
+// so that is held as a position rather than in the array. Use getCell and setCell rather than accessing the array.
+// The array is taken from the maze's arena each level, so it is only as big as the level needs. The arena is one
+// block of memory that is reset for each level rather than freed, and only grows when a level needs more than before.
+struct maze
+{
+	unsigned char* cells;				// Bit array containing the maze to be solved.
+	unsigned int Msize;					// Maze size, cells along each side.
+	unsigned int Mrows;					// Rows in the maze, the same as Msize except in long corridor mode.
+	unsigned int rowBytes;				// Bytes used for each row of the maze at one bit per cell.
+	unsigned int exitX;					// Exit position, set outside of the maze until the exit is placed.
+	unsigned int exitY;
+	unsigned int exitPath;				// Moves wanted from the start to the exit, 0 for as far as possible.
+	unsigned int candidates;			// Candidate mazes the maze is picked from.
+	struct mazestats stats;				// Measures of the maze, from placing the exit.
+	unsigned int* toExit;				// Moves from each cell to the exit, UINT_MAX for walls, NULL if not known.
+	unsigned char* visited;				// Bit for each cell the player has been in, laid out as cells, NULL if not kept.
+	unsigned int level;					// Level the maze is for.
+	uint32_t seed;						// Seed the maze is made from.
+	mazemode_t mode;					// Shape of the maze, a value from enum MAZEMODE.
+	mazegen_t gen;						// Generator used for the maze, a value from enum MAZEGEN.
+	struct rng rng;						// Random numbers for making the maze.
+	bool ready;							// Set once the maze has been made.
+	unsigned char* arena;				// Memory for the arena.
+	size_t arenaSize;					// Size of the arena memory in bytes.
+	size_t arenaUsed;					// Bytes of the arena currently in use.
+	size_t arenaPeak;					// Most bytes of the arena in use at once since it was last reset.
+	size_t genBytes;					// Most working memory the generator took from the arena, for the tools.
+	unsigned int* rowSet;				// Long corridor mode, set each block in the current row is in, numbered 0 to width - 1.
+	unsigned char* rowDown;				// Flag for each block in the current row, set if it has a passage to the next row.
+	unsigned char* setFlag;				// Working flag for each set number.
+	unsigned int nextRow;				// Next row of blocks to be made, rows before this are in the ring buffer.
+	unsigned int exitRow;				// Row of blocks that the exit is put in.
+	struct chunk* chunks;				// Open world mode, chunks kept, from the arena.
+	struct chunk* lastChunk;			// Chunk used last, it is usually the one wanted next.
+	unsigned int chunkClock;			// Count of chunk look ups, used to time stamp chunk use.
+	unsigned int worldSeed;				// Seed the whole world is made from.
+	unsigned int exitCx, exitCy;		// Chunk with the exit in it.
+};
+
+// A pack of mazes from a .lab file can be used instead of generating them. The file starts with a header (PACKHEAD bytes:
+// "LAB1", version and number of levels), then an index entry for each level (PACKINDEX bytes: level and offset in the file)
+// in level order, so a level is found with a binary search however many levels the pack holds.
+// Each level is a header (PACKLEVEL bytes: level, seed, size, bytes per row, exit x, y and start x, y) followed by the
+// bit-packed grid exactly as the maze array holds it, so a level is played straight from the file without being copied.
+// Numbers are 32-bit, least significant byte first.
+#define PACKMAGIC   "LAB1"				// Start of every pack file.
+#define PACKVERSION 1					// Version of the pack format.
+#define PACKHEAD    16					// Bytes of the file header.
+#define PACKINDEX   8					// Bytes of each index entry.
+#define PACKLEVEL   32					// Bytes of each level header.
+#define PACKFILE    "levels.lab"		// Pack opened when no file is given, in the game's directory.
+
+// In long corridor mode the maze carries on south for ever. It is made a row of blocks at a time with Eller's algorithm,
+// which only needs to know which set each block in the current row is in. Rows are kept in a ring buffer, so the rows
+// far enough behind the player are overwritten by new rows ahead of them, and memory depends only on the maze width.
+#define RINGBLKS   16					// Rows of blocks kept in the ring buffer.
+#define AHEADBLKS  4					// Rows of blocks made ahead of the player, more than can be seen along a corridor.
+#define CORRIDORLEN 4					// Exit is this many times further down than the maze is wide.
+#define SAMESETJOIN 4					// One in this many blocks next to each other in the same set are joined.
+
+// In open world mode the maze carries on in every direction. It is split into square chunks of blocks, each made from the
+// world seed and its position the first time it is looked at, so a chunk is always the same however many times it is made.
+// Only a few chunks are kept, the one not used for longest is dropped to make room for a new one, so memory doesn't grow
+// however far the player goes.
+#define CHUNKBLKS  8					// Blocks along each side of a chunk.
+#define CHUNKCELLS (CHUNKBLKS * BLKSIZE)	// Cells along each side of a chunk.
+#define CHUNKROW   ((CHUNKCELLS + 7) / 8)	// Bytes for each row of a chunk at one bit per cell.
+#define CHUNKCACHE 16					// Chunks kept, more than the player can see around them.
+#define WORLDMID   0x01000000u			// Chunk the player starts in, in the middle of the world so they can go any way.
+
+struct chunk
+{
+	unsigned int cx, cy;				// Position of the chunk in the world, in chunks.
+	unsigned int used;					// When the chunk was last used, to find the least recently used chunk.
+	bool valid;							// Set once the chunk has been made.
+	unsigned char cells[CHUNKCELLS][CHUNKROW];	// Bit array for the chunk, the same as the maze array.
+};
+
+// Everything about a game being played, so that more than one game can be played at once. There are two mazes. While
+// one is being played the next level's maze is made in the other on a worker thread, so finishing a level only has to
+// swap them over. The functions without a game play defaultGame, which is the only one that keeps the level in the file.
+struct game
+{
+	struct maze mazes[2];				// The two mazes, cur and ahead point at them.
+	struct maze* cur;					// Maze being played.
+	struct maze* ahead;					// Maze for the next level, made in the background.
+	struct thread worker;				// Thread making the next level's maze.
+	bool working;						// Set from starting the worker thread until it is joined.
+	struct maze* spares[MAXCANDIDATES];	// Mazes for the candidates other than the first, kept for re-use.
+
+	mazemode_t mode;					// Shape of maze selected, a value from enum MAZEMODE.
+	mazegen_t generator;				// Generator selected, or GENBYLEVEL to choose from the level.
+	uint32_t mazeSeed;					// Seed the next maze is made from.
+	unsigned int exitPath;				// Moves wanted from the start to the exit, 0 for as far as possible.
+	unsigned int candidates;			// Candidate mazes each maze is picked from.
+	bool endless;						// Endless mode, the level is not limited to MAXLEVEL.
+	bool levelFile;						// Set if the level is saved in the level file, otherwise it is only in memory.
+	bool levelRead;						// Set once the level file has been read, after that the level is kept in memory.
+	bool levelHeld;						// Set while the level file is held, levels are then only set in memory.
+	unsigned int savedLevel;			// Level last saved, what the level file holds once storage has written it unless held.
+
+	const unsigned char* pack;			// Contents of the open pack file, NULL if there isn't one.
+	size_t packBytes;					// Size of the pack file.
+	unsigned int packStartX;			// Player start position for the last level taken from the pack.
+	unsigned int packStartY;
+
+	unsigned int playerX;				// Player X position in mazeArray
+	unsigned int playerY;				// Player Y postiion in mazeArray
+	unsigned int playerD;				// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left)
+	unsigned int level;					// Game Level
+};
+
+// The player position is initialised to be on the safe side but is set up in the game.
+static struct game defaultGame = { .cur = &defaultGame.mazes[0], .ahead = &defaultGame.mazes[1], .mode = MODENORMAL,
+								   .generator = GENBLOCKS, .mazeSeed = 1, .candidates = 1, .levelFile = true,
+								   .playerX = 2, .playerY = 2, .playerD = 4 };
+
+static void makeRowsAhead(struct maze* m, unsigned int y);	// Make rows of the maze ahead of row y in long corridor mode.
+static struct chunk* getChunk(struct maze* m, unsigned int cx, unsigned int cy);	// Find or make a chunk for open world mode.
+static void measureToExit(struct maze* m);		// Work out the moves from each cell to the exit.
+
+// Random mazes are assembled from building block tiles, one for each set of sides that have a corridor out of them.
+// The sides are a mask, TILEN, TILEE, TILES and TILEW, so there are dead ends, straights, corners, 3-way junctions and a
+// crossing. Every row above the centre of a tile is the same, as is every row below, so a tile only needs those and the
+// centre row, as bits with a set bit for a wall. This works for any odd BLKSIZE. With the original 3 x 3 size:
+//  N+E+W  N+E+S  E+S+W  N+S+W  N+E+S+W  N+S  N+E   N
+// # #    # #    ###    # #    # #      # #  # #  # #
+//        #             #               # #  #    # #
+// ###    # #    # #    # #    # #      # #  ###  ###
+//
+#if ((BLKSIZE % 2) == 0) || (BLKSIZE > 25)
+#error BLKSIZE must be odd and no more than 25, so a row of a tile fits in 32 bits wherever it starts in a byte
+#endif
+#define TILEN 1							// Tile has a corridor to the north.
+#define TILEE 2							// Tile has a corridor to the east.
+#define TILES 4							// Tile has a corridor to the south.
+#define TILEW 8							// Tile has a corridor to the west.
+#define TILEFULL   ((1u << BLKSIZE) - 1)				// Row of wall across a tile.
+#define TILECENTRE (1u << (BLKSIZE / 2))				// Centre cell of a row.
+#define TILEWEST   (TILECENTRE - 1)						// Cells west of the centre.
+#define TILEEAST   (TILEFULL & ~((TILECENTRE << 1) - 1))	// Cells east of the centre.
+#define TILE(w) { { TILEFULL & ~(((w) & TILEN) ? TILECENTRE : 0), \
+					TILEFULL & ~TILECENTRE & ~(((w) & TILEW) ? TILEWEST : 0) & ~(((w) & TILEE) ? TILEEAST : 0), \
+					TILEFULL & ~(((w) & TILES) ? TILECENTRE : 0) } }
+#define TILECHOICES 18					// Most tiles listed for one set of sides.
+#define TILELEADON  16					// Only use tiles that lead on while the worklist is shorter than this.
+
+// Rows of a building block tile, a set bit for a wall.
+struct tile
+{
+	uint32_t rows[3];					// Rows above the centre, the centre row and the rows below it.
+};
+
+// Every tile, by its mask of sides. Tile 0 is solid and is never used.
+static const struct tile tiles[16] = { TILE(0), TILE(1), TILE(2), TILE(3), TILE(4), TILE(5), TILE(6), TILE(7),
+									   TILE(8), TILE(9), TILE(10), TILE(11), TILE(12), TILE(13), TILE(14), TILE(15) };
+
+// The tiles that can go in a block, for each set of sides that corridors lead in from, so a tile is picked with one
+// random number and no tests. Each tile joins every corridor leading in. 3-way tiles are listed four times, the crossing
+// twice and straights and corners once, so most blocks lead on to more blocks and the maze keeps growing. Dead ends
+// aren't listed, they come from closing off the sides of a tile that can't lead anywhere. The second set is used while the
+// worklist is short, including for the first block, and only has tiles that lead on, so the maze can't stop growing
+// straight away.
+static const unsigned char tileChoice[2][16][TILECHOICES] = {
+	{
+		{  7,  7,  7,  7, 11, 11, 11, 11, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15 },
+		{  3,  5,  7,  7,  7,  7,  9, 11, 11, 11, 11, 13, 13, 13, 13, 15, 15 },
+		{  3,  6,  7,  7,  7,  7, 10, 11, 11, 11, 11, 14, 14, 14, 14, 15, 15 },
+		{  3,  7,  7,  7,  7, 11, 11, 11, 11, 15, 15 },
+		{  5,  6,  7,  7,  7,  7, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15 },
+		{  5,  7,  7,  7,  7, 13, 13, 13, 13, 15, 15 },
+		{  6,  7,  7,  7,  7, 14, 14, 14, 14, 15, 15 },
+		{  7,  7,  7,  7, 15, 15 },
+		{  9, 10, 11, 11, 11, 11, 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15 },
+		{  9, 11, 11, 11, 11, 13, 13, 13, 13, 15, 15 },
+		{ 10, 11, 11, 11, 11, 14, 14, 14, 14, 15, 15 },
+		{ 11, 11, 11, 11, 15, 15 },
+		{ 12, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15 },
+		{ 13, 13, 13, 13, 15, 15 },
+		{ 14, 14, 14, 14, 15, 15 },
+		{ 15, 15 }
+	},
+	{
+		{  7,  7,  7,  7, 11, 11, 11, 11, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15 },
+		{  7,  7,  7,  7, 11, 11, 11, 11, 13, 13, 13, 13, 15, 15 },
+		{  7,  7,  7,  7, 11, 11, 11, 11, 14, 14, 14, 14, 15, 15 },
+		{  7,  7,  7,  7, 11, 11, 11, 11, 15, 15 },
+		{  7,  7,  7,  7, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15 },
+		{  7,  7,  7,  7, 13, 13, 13, 13, 15, 15 },
+		{  7,  7,  7,  7, 14, 14, 14, 14, 15, 15 },
+		{  7,  7,  7,  7, 15, 15 },
+		{ 11, 11, 11, 11, 13, 13, 13, 13, 14, 14, 14, 14, 15, 15 },
+		{ 11, 11, 11, 11, 13, 13, 13, 13, 15, 15 },
+		{ 11, 11, 11, 11, 14, 14, 14, 14, 15, 15 },
+		{ 11, 11, 11, 11, 15, 15 },
+		{ 13, 13, 13, 13, 14, 14, 14, 14, 15, 15 },
+		{ 13, 13, 13, 13, 15, 15 },
+		{ 14, 14, 14, 14, 15, 15 },
+		{ 15, 15 }
+	}
+};
+static const unsigned char tileChoices[2][16] = { { 18, 17, 17, 11, 17, 11, 11, 6, 17, 11, 11, 6, 11, 6, 6, 2 },	// Tiles listed in each row.
+												  { 18, 14, 14, 10, 14, 10, 10, 6, 14, 10, 10, 6, 10, 6, 6, 2 } };
+
+// Mix a number so that every bit depends on every bit of the input (splitmix32 style).
+// Used to spread a seed over the generator state and to move on to the next level's seed.
+static uint32_t mixSeed(uint32_t x)
+{
+	x += 0x9E3779B9u;
+	x ^= x >> 16;
+	x *= 0x85EBCA6Bu;
+	x ^= x >> 13;
+	x *= 0xC2B2AE35u;
+	x ^= x >> 16;
+	return x;
+}
+
+// Start a random number sequence from a seed.
+static void rngSeed(struct rng* r, uint32_t seed)
+{
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		seed = mixSeed(seed);
+		r->s[i] = seed;
+	}
+	if ((r->s[0] | r->s[1] | r->s[2] | r->s[3]) == 0) { r->s[0] = 1; }
+}
+
+// Get the next random number in the sequence.
+static uint32_t rngNext(struct rng* r)
+{
+	uint32_t result = r->s[1] * 5;		// Output scrambler.
+	uint32_t t = r->s[1] << 9;
+
+	result = ((result << 7) | (result >> 25)) * 9;
+
+	r->s[2] ^= r->s[0];
+	r->s[3] ^= r->s[1];
+	r->s[1] ^= r->s[2];
+	r->s[0] ^= r->s[3];
+	r->s[2] ^= t;
+	r->s[3] = (r->s[3] << 11) | (r->s[3] >> 21);
+	return result;
+}
+
+// Get a random number from 0 to n - 1, with every value equally likely. Rather than % (which favours low values) the
+// number is scaled into range with a multiply, only drawing again in the rare case that it lands in the uneven part.
+static uint32_t rngRange(struct rng* r, uint32_t n)
+{
+	uint64_t m = (uint64_t)rngNext(r) * n;	// Random number scaled by n, the top 32 bits are the result.
+	uint32_t limit;							// Low parts below this would make some results more likely.
+
+	if ((uint32_t)m < n)
+	{
+		limit = (0u - n) % n;
+		while ((uint32_t)m < limit) { m = (uint64_t)rngNext(r) * n; }
+	}
+	return (uint32_t)(m >> 32);
+}
+
+// Empty a maze's arena ready for the next level, making sure it can hold at least size bytes. Memory is kept for re-use,
+// so this is normally just resetting the used count. Returns false if the arena needed to grow and couldn't.
+static bool arenaReset(struct maze* m, size_t size)
+{
+	unsigned char* mem;		// Grown arena memory.
+	size_t newSize;			// New arena size.
+
+	m->arenaUsed = 0;
+	m->arenaPeak = 0;
+	if (size > m->arenaSize)
+	{
+		// Double the size each time it grows, so that moving up the levels does not keep growing it.
+		newSize = (m->arenaSize * 2 > size) ? m->arenaSize * 2 : size;
+		mem = realloc(m->arena, newSize);
+		if (mem == NULL) { return false; }
+		m->arena = mem;
+		m->arenaSize = newSize;
+	}
+	return true;
+}
+
+// Take size bytes from a maze's arena. Returns NULL if there isn't room, arenaReset sets the size for the level.
+static void* arenaAlloc(struct maze* m, size_t size)
+{
+	unsigned char* mem;		// Start of the memory given out.
+
+	// Keep everything given out aligned, so that any type can be put in the arena.
+	size = (size + 7) & ~(size_t)7;
+	if ((m->arenaUsed + size) > m->arenaSize) { return NULL; }
+
+	mem = m->arena + m->arenaUsed;
+	m->arenaUsed += size;
+	if (m->arenaUsed > m->arenaPeak) { m->arenaPeak = m->arenaUsed; }
+	return mem;
+}
+
+// Arena bytes needed for the distances to the exit of a maze of cols by rows cells, and the queue to work them out.
+static size_t toExitBytes(unsigned int cols, unsigned int rows)
+{
+	return (((size_t)cols * rows * sizeof(unsigned int) + 7) & ~(size_t)7) * 2;
+}
+
+// Get the start of row y in the maze array. In long corridor mode this is the row's place in the ring buffer,
+// or NULL if the row is not in the ring buffer (not made yet, or already overwritten).
+static unsigned char* mazeRow(struct maze* m, unsigned int y)
+{
+	unsigned int blkRow;	// Row of blocks that y is in.
+
+	if (m->mode != MODECORRIDOR) { return m->cells + (y * m->rowBytes); }
+
+	if (y < MAZEBORDER) { return NULL; }
+	blkRow = (y - MAZEBORDER) / BLKSIZE;
+	if ((blkRow >= m->nextRow) || ((blkRow + RINGBLKS) < m->nextRow)) { return NULL; }
+	return m->cells + ((((blkRow % RINGBLKS) * BLKSIZE) + ((y - MAZEBORDER) % BLKSIZE)) * m->rowBytes);
+}
+
+// Get the character for a cell in the maze, '#' for a block, ' ' for a space and 'E' for the exit.
+// The caller must keep x and y within the maze array.
+static char getCell(struct maze* m, unsigned int x, unsigned int y)
+{
+	unsigned char* row;		// Row the cell is in.
+	struct chunk* ch;		// Chunk the cell is in, for open world mode.
+
+	if ((x == m->exitX) && (y == m->exitY)) { return 'E'; }
+
+	if (m->mode == MODEWORLD)
+	{
+		ch = getChunk(m, x / CHUNKCELLS, y / CHUNKCELLS);
+		x = x % CHUNKCELLS;
+		return (ch->cells[y % CHUNKCELLS][x >> 3] & (1u << (x & 7))) ? '#' : ' ';
+	}
+
+	row = mazeRow(m, y);
+	if (row == NULL) { return '#'; }
+	return (row[x >> 3] & (1u << (x & 7))) ? '#' : ' ';
+}
+
+// Set a cell in the maze from its character, '#' for a block, ' ' for a space and 'E' for the exit.
+static void setCell(struct maze* m, unsigned int x, unsigned int y, char c)
+{
+	unsigned char* row = mazeRow(m, y);	// Row the cell is in.
+
+	if (row == NULL) { return; }
+	if (c == '#') { row[x >> 3] |= (unsigned char)(1u << (x & 7)); }
+	else          { row[x >> 3] &= (unsigned char)~(1u << (x & 7)); }
+
+	if (c == 'E') { m->exitX = x; m->exitY = y; }
+	else if ((x == m->exitX) && (y == m->exitY)) { m->exitX = UINT_MAX; m->exitY = UINT_MAX; }
+}
+
+// Mark a cell as visited by the player, if the maze keeps track of them.
+static void setVisited(struct maze* m, unsigned int x, unsigned int y)
+{
+	if (m->visited == NULL) { return; }
+	m->visited[(y * m->rowBytes) + (x >> 3)] |= (unsigned char)(1u << (x & 7));
+}
+
+// Process to show a 2D representation of the full maze to aid program development on PC.
+void gameTwoDdisplay(struct game* g)
+{
+	unsigned int x0 = 0, y0 = 0;	// Area of the maze to display.
+	unsigned int x1 = g->cur->Msize, y1 = g->cur->Msize;
+
+	if (g->cur->ready == false) { return; }
+
+	// The long corridor and open world carry on for ever, so only show the area around the player.
+	if (g->cur->mode != MODENORMAL)
+	{
+		y0 = (g->playerY > 24) ? g->playerY - 24 : 0;
+		y1 = g->playerY + 25;
+		if (g->cur->mode == MODEWORLD)
+		{
+			x0 = g->playerX - 24;
+			x1 = g->playerX + 25;
+		}
+	}
+
+	// Display the Maze array contents
+	for (unsigned int y = y0; y < y1; y++) 
+	{
+		for (unsigned int x = x0; x < x1; x++) 
+		{
+			// Display the maze, but also show where the player is in the maze.
+			// Note the array is vertical index first.
+			if ((g->playerX == x) && (g->playerY == y)) 
+			{ 
+				// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left)
+				switch (g->playerD)
+				{
+					case 1:  { printf("^"); break; }
+					case 2:  { printf(">"); break; }
+					case 3:  { printf("_"); break; }
+					default: { printf("<"); break; }
+				}
+			}
+			else								  
+			{ 
+				printf("%c", getCell(g->cur, x, y)); 
+			}
+		}
+		printf("\n");
+	}
+	printf("\n");
+}
+
+// Accessor to get view along the corridor for the player in the direction they are facing.
+// f is forward 0 to 8 along the corridor.
+// s is side -1 for left side, 0 for along corridor, and 1 for right side.
+char gameGet3DView(struct game* g, int f, int s)
+{
+	long long xi = 0;		// Working indices, signed so a view off the top or left of the maze is seen as outside it.
+	long long yi = 0;
+
+	// If the view requested is outside of the valid range for looking along a corridor return a block.
+	if ((f < 0) || (f > 8) || (s < -1) || (s > 1))
+	{
+		return '#';
+	}
+
+	// The view to be returned depends on which direction the player is facing.
+	switch (g->playerD)
+	{
+		case 1: // North
+		{
+			// Working index is the offset from the current player position.
+			xi = (long long)g->playerX + s;
+			yi = (long long)g->playerY - f;
+			break;
+		}
+		case 2:	// East
+		{
+			xi = (long long)g->playerX + f;
+			yi = (long long)g->playerY + s;
+			break;
+		}
+		case 3:	// South
+		{
+			xi = (long long)g->playerX - s;
+			yi = (long long)g->playerY + f;
+			break;
+		}
+		default:	// West
+		{
+			xi = (long long)g->playerX - f;
+			yi = (long long)g->playerY - s;
+			break;
+		}
+	}
+
+	// If the player position is inside the maze find the correct character.
+	if ((xi >= 0) && (xi < g->cur->Msize) && (yi >= 0) && (yi < g->cur->Mrows))
+	{
+		// Return the character within the maze for the requested part of the corridor view.
+		return getCell(g->cur, (unsigned int)xi, (unsigned int)yi);
+	}
+	// For anything that is out of range report it as a block.
+	return '#';
+}
+
+// Accessor to get any character from the maze including showing the player position and direction.
+// This can be used to have a player aid in the Wii U game and helps with the PC development of the game.
+char gameGet2DView(struct game* g, int x, int y)
+{
+	long long xi, yi;		// Working indices, signed so a view off the top or left of the maze is seen as outside it.
+
+	// Working index is the offset from the current player position.
+	xi = (long long)g->playerX + x;
+	yi = (long long)g->playerY + y;
+
+	// If the player position is inside the maze find the correct character.
+	if ((xi >= 0) && (xi < g->cur->Msize) && (yi >= 0) && (yi < g->cur->Mrows))
+	{
+		// If the indices are the player position, show the player direction.
+		if ((y == 0) && (x == 0))
+		{
+			// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left)
+			// ASCII characters are used in the PC version. Really these need to be arrows.
+			// On the Wii U a custom character set is used, so the ASCII characters actually display as arrows.
+			switch (g->playerD)
+			{
+			case 1:  { return '^'; }
+			case 2:  { return '>'; }
+			case 3:  { return '_'; }	// Best ASCII character I can do for down.
+			default: { return '<'; }
+			}
+		}
+		else
+		{
+			// Return the character for the position within the maze requested.
+			return getCell(g->cur, (unsigned int)xi, (unsigned int)yi);
+		}
+	}
+	// For anything that is out of range report it as a block.
+	return '#';
+}
+
+// Move l for turn left, r for turn right and f for forward.
+// Return 0 if move was not possible, 1 if move was performed and 2 if end of level.
+unsigned int gameMovePlayer(struct game* g, char move)
+{
+	// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left)
+	// Turn left.
+	if ((move == 'l') || (move == 'L'))
+	{
+		g->playerD--;
+		if (g->playerD < 1) { g->playerD = 4; }
+		putsoundSel(TURN);
+		return 1;
+	}
+	// Turn right.
+	if ((move == 'r') || (move == 'R'))
+	{
+		g->playerD++;
+		if (g->playerD > 4) { g->playerD = 1; }
+		putsoundSel(TURN);
+		return 1;
+	}
+
+	// Moving forward depends on direction. Nothing can be moved into in a maze that couldn't be made.
+	if (((move == 'f') || (move == 'F')) && (g->cur->ready == true))
+	{
+		//1=North(up)
+		if ((g->playerD == 1) && (getCell(g->cur, g->playerX, g->playerY - 1) == ' '))
+		{
+			g->playerY--;
+			setVisited(g->cur, g->playerX, g->playerY);
+			putsoundSel(MOVE);
+			return 1;
+		}
+		//2=East(right)
+		if ((g->playerD == 2) && (getCell(g->cur, g->playerX + 1, g->playerY) == ' '))
+		{
+			g->playerX++;
+			setVisited(g->cur, g->playerX, g->playerY);
+			putsoundSel(MOVE);
+			return 1;
+		}
+		//3=South(down)
+		if ((g->playerD == 3) && (getCell(g->cur, g->playerX, g->playerY + 1) == ' '))
+		{
+			g->playerY++;
+			if (g->cur->mode == MODECORRIDOR) { makeRowsAhead(g->cur, g->playerY); }
+			setVisited(g->cur, g->playerX, g->playerY);
+			putsoundSel(MOVE);
+			return 1;
+		}
+		//4=West(left)
+		if ((g->playerD == 4) && (getCell(g->cur, g->playerX - 1, g->playerY) == ' '))
+		{
+			g->playerX--;
+			setVisited(g->cur, g->playerX, g->playerY);
+			putsoundSel(MOVE);
+			return 1;
+		}
+		// Check to see if the exit is found.
+		if (((g->playerD == 1) && (getCell(g->cur, g->playerX, g->playerY - 1) == 'E')) ||
+			((g->playerD == 2) && (getCell(g->cur, g->playerX + 1, g->playerY) == 'E')) ||
+			((g->playerD == 3) && (getCell(g->cur, g->playerX, g->playerY + 1) == 'E')) ||
+			((g->playerD == 4) && (getCell(g->cur, g->playerX - 1, g->playerY) == 'E')))
+		{
+			// Increment the level as the current maze is complete
+			g->level++;
+			if ((g->endless == false) && (g->level > MAXLEVEL)) { g->level = MAXLEVEL; }
+
+			// Overwrite the old data file with the new level, then return 2 to indicate the level is complete.
+			gameWriteLevel(g, g->level);
+			putsoundSel(WIN);
+			return 2;
+		}
+	}
+	return 0;	// Move did not work.
+}
+
+// Get the moves from the player to the exit, from the distances worked out with the maze, so it costs a lookup.
+// Returns 0 if this isn't known, as in long corridor and open world mode where the maze is made as the player goes.
+unsigned int gameGetDistanceToExit(struct game* g)
+{
+	unsigned int d;		// Moves to the exit from the player.
+
+	if ((g->cur->ready == false) || (g->cur->toExit == NULL) || (g->cur->mode != MODENORMAL)) { return 0; }
+	d = g->cur->toExit[(g->playerY * g->cur->Msize) + g->playerX];
+	return (d == UINT_MAX) ? 0 : d;
+}
+
+// Get the direction of the next move towards the exit, 1=North(up), 2=East(right), 3=South(down), 4=West(left), the
+// same as the player direction. Returns 0 if this isn't known.
+unsigned int gameGetHintDirection(struct game* g)
+{
+	unsigned int d = gameGetDistanceToExit(g);			// Moves to the exit from the player.
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for each direction.
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+
+	if (d == 0) { return 0; }
+	for (unsigned int dir = 1; dir <= 4; dir++)
+	{
+		if (g->cur->toExit[((g->playerY + dy[dir]) * g->cur->Msize) + g->playerX + dx[dir]] == d - 1) { return dir; }
+	}
+	return 0;
+}
+
+// Get where the player is in the maze and the way they face, 1=North(up), 2=East(right), 3=South(down), 4=West(left).
+// Any of the pointers can be NULL if that part isn't wanted.
+void gameGetPlayerPosition(struct game* g, unsigned int* x, unsigned int* y, unsigned int* d)
+{
+	if (x != NULL) { *x = g->playerX; }
+	if (y != NULL) { *y = g->playerY; }
+	if (d != NULL) { *d = g->playerD; }
+}
+
+// Get the move for movePlayer that takes the player towards the exit, 'f' when facing the way to go, otherwise the turn
+// towards it. Returns 0 if the way isn't known.
+char gameGetSolveMove(struct game* g)
+{
+	unsigned int dir = gameGetHintDirection(g);	// Direction to move in.
+
+	if (dir == 0) { return 0; }
+	if (dir == g->playerD) { return 'f'; }
+	return (dir == (g->playerD % 4) + 1) ? 'r' : 'l';
+}
+
+// Return the current level to the game so that it can be displayed.
+unsigned int gameGetLevel(struct game* g)
+{
+	return g->level;
+}
+
+// Return the level of the maze being played. Once the exit is found the game level has already moved on to the next
+// level, but this is still the level just completed.
+unsigned int gameGetPlayedLevel(struct game* g)
+{
+	return g->cur->level;
+}
+
+// Return the seed the maze being played was made from, so it can be kept with how the level was played.
+unsigned int gameGetPlayedSeed(struct game* g)
+{
+	return g->cur->seed;
+}
+
+// Return the generator the maze being played was made with, rather than the one selected, so taking turns by level is
+// kept as the generator actually used. GENCOUNT if the maze came from a pack. Only normal mazes use the generator.
+mazegen_t gameGetPlayedGenerator(struct game* g)
+{
+	return g->cur->gen;
+}
+
+// Return the shape of the maze being played, which stays the same if the shape selected changes part way through it.
+mazemode_t gameGetPlayedMode(struct game* g)
+{
+	return g->cur->mode;
+}
+
+// Turn endless mode on or off. In endless mode the level keeps going up past MAXLEVEL.
+void gameSetEndless(struct game* g, bool on)
+{
+	g->endless = on;
+}
+
+// Return true if the game is in endless mode.
+bool gameGetEndless(struct game* g)
+{
+	return g->endless;
+}
+
+// Set the seed that the next maze is made from. The same seed always gives the same maze.
+void gameSetSeed(struct game* g, unsigned int seed)
+{
+	g->mazeSeed = seed;
+}
+
+// Return the seed that the next maze will be made from, to show to the player as a code they can share.
+unsigned int gameGetSeed(struct game* g)
+{
+	return g->mazeSeed;
+}
+
+// Set how many moves the path from the start to the exit should be, for the next maze. The exit goes at the dead end with
+// the path nearest to this. 0 puts the exit as far from the start as possible.
+void gameSetExitPath(struct game* g, unsigned int moves)
+{
+	g->exitPath = moves;
+}
+
+// Return the moves wanted from the start to the exit, 0 for as far as possible.
+unsigned int gameGetExitPath(struct game* g)
+{
+	return g->exitPath;
+}
+
+// Set how many candidate mazes each maze is picked from, for the next maze.
+void gameSetCandidates(struct game* g, unsigned int count)
+{
+	if (count < 1) { count = 1; }
+	if (count > MAXCANDIDATES) { count = MAXCANDIDATES; }
+	g->candidates = count;
+}
+
+// Return how many candidate mazes each maze is picked from.
+unsigned int gameGetCandidates(struct game* g)
+{
+	return g->candidates;
+}
+
+// Get the measures of the maze being played. Only normal mazes that were generated are measured.
+void gameGetStats(struct game* g, struct mazestats* stats)
+{
+	*stats = g->cur->stats;
+}
+
+// Select the shape of maze played from the next maze, a value from enum MAZEMODE.
+void gameSetMode(struct game* g, mazemode_t newMode)
+{
+	if (newMode >= MODECOUNT) { newMode = MODENORMAL; }
+	g->mode = newMode;
+}
+
+// Return the shape of maze selected, a value from enum MAZEMODE.
+mazemode_t gameGetMode(struct game* g)
+{
+	return g->mode;
+}
+
+// Return the name of a maze shape to show the player.
+const char* getModeName(mazemode_t m)
+{
+	switch (m)
+	{
+		case MODECORRIDOR: { return "Long corridor"; }
+		case MODEWORLD:    { return "Open world"; }
+		default:           { return "Normal"; }
+	}
+}
+
+// Queue a level to be written to the level file by the saver thread, return false if this fails. Storage writes it in
+// place of the level file in one go, so the level file is never left part written whenever the game stops.
+static bool saveLevelFile(unsigned int lvl)
+{
+	char text[40];		// Text of the level file.
+
+	// To aid development and diagnostics, the names of the variable is also output to the text file.
+	sprintf(text, "%u \nlevel \n", lvl);
+	return storageQueue(LEVELFILE, text, strlen(text), false);
+}
+
+// Read the level from the level file. Return 0 if there isn't a level file.
+static unsigned int loadLevelFile(void)
+{
+	struct storefile* inFile;
+	char text[40];		// Text of the level file.
+	size_t bytes;		// Bytes read.
+	int lvl = 1;		// Level read.
+
+	inFile = storageOpen(LEVELFILE, false);
+	if (inFile == NULL) { return 0; }
+	bytes = storageRead(inFile, text, sizeof(text) - 1);
+	storageClose(inFile);
+	text[bytes] = '\0';
+	sscanf(text, "%d", &lvl);
+	return (lvl < 1) ? 1 : (unsigned int)lvl;
+}
+
+// Set the level and save it. The level in memory is the one the game uses, the level file is written in the background
+// so the game never waits for it. Games other than the default one only keep it in memory. Return false if writing
+// it straight away failed.
+bool gameWriteLevel(struct game* g, unsigned int newLevel)
+{
+	// If the level is less than 1 set it to 1.
+	// If the level is above MAXLEVEL set to MAXLEVEL, unless in endless mode.
+	g->level = newLevel;
+	if (g->level < 1) { g->level = 1; }
+	if ((g->endless == false) && (g->level > MAXLEVEL)) { g->level = MAXLEVEL; }
+	g->savedLevel = g->level;
+	g->levelRead = true;
+
+	if ((g->levelFile == false) || (g->levelHeld == true)) { return true; }
+	return saveLevelFile(g->level);
+}
+
+// Hold the level file, or let it go again. While it is held the level is only set in memory, so the level file keeps
+// the player's own level whenever the game stops, such as part way through a replay.
+void gameHoldLevelFile(struct game* g, bool hold)
+{
+	if (hold == true) { gameReadLevel(g); }		// Read the player's level before it is set in memory.
+	g->levelHeld = hold;
+}
+
+// Get the level saved, limited for the current mode. The level file is only read the first time, if it isn't there it
+// is created at level 1. After that the level saved is kept in memory, so this doesn't touch the file.
+unsigned int gameReadLevel(struct game* g)
+{
+	if ((g->levelFile == true) && (g->levelRead == false))
+	{
+		g->savedLevel = loadLevelFile();
+		g->levelRead = true;
+
+		// If the file isn't there create it.
+		if (g->savedLevel == 0) { gameWriteLevel(g, 1); }
+	}
+
+	// Limit the level to a valid range, just in case, and to MAXLEVEL unless in endless mode.
+	g->level = g->savedLevel;
+	if (g->level < 1) { g->level = 1; }
+	if ((g->endless == false) && (g->level > MAXLEVEL)) { g->level = MAXLEVEL; }
+	return g->level;
+}
+
+// Get a 32-bit number stored least significant byte first in a maze pack, so packs are the same on the Wii U and a PC.
+static uint32_t get32(const unsigned char* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Put a 32-bit number in a maze pack, least significant byte first.
+static void put32(unsigned char* p, uint32_t v)
+{
+	p[0] = (unsigned char)v;
+	p[1] = (unsigned char)(v >> 8);
+	p[2] = (unsigned char)(v >> 16);
+	p[3] = (unsigned char)(v >> 24);
+}
+
+// Write a pack of mazes to a .lab file, return false if this fails. The mazes must be normal mazes made with makeMaze.
+// They are written in level order, if there is more than one maze for a level the first one given is played.
+bool savePack(const char* fileName, struct maze* packMazes[], unsigned int count)
+{
+	FILE* outFile;
+	unsigned char head[PACKLEVEL];		// Header for the file, index entry or level.
+	uint32_t offset;					// Offset of the next level in the file.
+	size_t bytes;						// Bytes of a level's grid.
+	struct maze** order;				// Mazes in level order.
+	struct maze* m;						// Maze being put in order or written.
+	unsigned int j;
+
+	// Put the mazes in level order, keeping mazes for the same level in the order given. They are normally given in
+	// order already, so an insertion sort is quick.
+	order = malloc(((count > 0) ? count : 1) * sizeof(struct maze*));
+	if (order == NULL) { return false; }
+	for (unsigned int i = 0; i < count; i++)
+	{
+		m = packMazes[i];
+		for (j = i; (j > 0) && (order[j - 1]->level > m->level); j--) { order[j] = order[j - 1]; }
+		order[j] = m;
+	}
+
+	outFile = fopen(fileName, "wb");
+	if (outFile == NULL)
+	{
+		free(order);
+		return false;
+	}
+
+	// File header, then the index of where each level is.
+	memset(head, 0, sizeof(head));
+	memcpy(head, PACKMAGIC, 4);
+	put32(head + 4, PACKVERSION);
+	put32(head + 8, count);
+	fwrite(head, 1, PACKHEAD, outFile);
+
+	offset = PACKHEAD + (count * PACKINDEX);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		put32(head, order[i]->level);
+		put32(head + 4, offset);
+		fwrite(head, 1, PACKINDEX, outFile);
+		bytes = (size_t)order[i]->Msize * order[i]->rowBytes;
+		offset += PACKLEVEL + (uint32_t)((bytes + 7) & ~(size_t)7);
+	}
+
+	// Each level's header then its grid, exactly as it is held in memory, padded so the next level is aligned.
+	for (unsigned int i = 0; i < count; i++)
+	{
+		m = order[i];
+		bytes = (size_t)m->Msize * m->rowBytes;
+		put32(head, m->level);
+		put32(head + 4, m->seed);
+		put32(head + 8, m->Msize);
+		put32(head + 12, m->rowBytes);
+		put32(head + 16, m->exitX);
+		put32(head + 20, m->exitY);
+		put32(head + 24, MAZEBORDER + (BLKSIZE / 2));
+		put32(head + 28, MAZEBORDER + (BLKSIZE / 2));
+		fwrite(head, 1, PACKLEVEL, outFile);
+		fwrite(m->cells, 1, bytes, outFile);
+		memset(head, 0, sizeof(head));
+		fwrite(head, 1, ((bytes + 7) & ~(size_t)7) - bytes, outFile);
+	}
+
+	free(order);
+	if (fclose(outFile) != 0) { return false; }
+	return true;
+}
+
+// Stop using the pack of mazes, normal mazes are then generated again.
+void gameClosePack(struct game* g)
+{
+	if (g->pack == NULL) { return; }
+
+	// If the maze being played is in the pack, it can't be played any more.
+	if ((g->cur->cells >= g->pack) && (g->cur->cells < (g->pack + g->packBytes)))
+	{
+		g->cur->cells = NULL;
+		g->cur->Msize = 0;
+		g->cur->Mrows = 0;
+		g->cur->ready = false;
+	}
+#ifdef __WIIU__
+	free((void*)g->pack);
+#else
+	munmap((void*)g->pack, g->packBytes);
+#endif
+	g->pack = NULL;
+	g->packBytes = 0;
+}
+
+// Open a pack of mazes, so that levels in it are played from the pack rather than generated. With a NULL fileName the
+// game's levels.lab is used, next to the level file. On a PC the file is mapped into memory, on the Wii U it is read in
+// one go. Either way the mazes are used where they are, without copying. Return false if there is no valid pack.
+bool gameOpenPack(struct game* g, const char* fileName)
+{
+	char path[STORAGEPATH];		// Full path to the pack.
+	const unsigned char* mem;	// Contents of the file.
+	size_t bytes;				// Size of the file.
+	uint32_t count;				// Levels in the pack.
+
+	gameClosePack(g);
+	fileName = storagePath((fileName != NULL) ? fileName : PACKFILE, path);
+
+#ifdef __WIIU__
+	FILE* inFile = fopen(fileName, "rb");
+	unsigned char* buf;
+	long len;
+
+	if (inFile == NULL) { return false; }
+	fseek(inFile, 0, SEEK_END);
+	len = ftell(inFile);
+	fseek(inFile, 0, SEEK_SET);
+	buf = (len > 0) ? memalign(64, (size_t)len) : NULL;
+	if ((buf == NULL) || (fread(buf, 1, (size_t)len, inFile) != (size_t)len))
+	{
+		free(buf);
+		fclose(inFile);
+		return false;
+	}
+	fclose(inFile);
+	mem = buf;
+	bytes = (size_t)len;
+#else
+	int fd = open(fileName, O_RDONLY);
+	struct stat st;
+	void* map;
+
+	if (fd < 0) { return false; }
+	if ((fstat(fd, &st) != 0) || (st.st_size <= 0))
+	{
+		close(fd);
+		return false;
+	}
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) { return false; }
+	mem = map;
+	bytes = (size_t)st.st_size;
+#endif
+
+	g->pack = mem;
+	g->packBytes = bytes;
+
+	// Check the header, that the index fits and that it is in level order for packFind. Each level is checked when it
+	// is used.
+	count = (bytes >= PACKHEAD) ? get32(mem + 8) : 0;
+	if ((bytes < PACKHEAD) || (memcmp(mem, PACKMAGIC, 4) != 0) || (get32(mem + 4) != PACKVERSION) ||
+		(count > ((bytes - PACKHEAD) / PACKINDEX)))
+	{
+		gameClosePack(g);
+		return false;
+	}
+	for (uint32_t i = 1; i < count; i++)
+	{
+		if (get32(mem + PACKHEAD + (i * PACKINDEX)) < get32(mem + PACKHEAD + ((i - 1) * PACKINDEX)))
+		{
+			gameClosePack(g);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Find a level in the open pack, returning its header, or NULL if the pack doesn't have a valid maze for the level.
+// The index is in level order, so this is a binary search for the first entry for the level.
+static const unsigned char* packFind(struct game* g, unsigned int lvl)
+{
+	const unsigned char* p;		// Level's header in the pack.
+	uint32_t offset;			// Offset of the level in the pack.
+	uint32_t size, row;			// Size and bytes for each row of the level.
+	uint32_t lo, hi, mid;		// Index entries still to search, from lo up to but not including hi.
+
+	if (g->pack == NULL) { return NULL; }
+
+	lo = 0;
+	hi = get32(g->pack + 8);
+	while (lo < hi)
+	{
+		mid = lo + ((hi - lo) / 2);
+		if (get32(g->pack + PACKHEAD + (mid * PACKINDEX)) < lvl) { lo = mid + 1; }
+		else { hi = mid; }
+	}
+	if ((lo == get32(g->pack + 8)) || (get32(g->pack + PACKHEAD + (lo * PACKINDEX)) != lvl)) { return NULL; }
+
+	// Check that the level is all inside the file and its positions are inside the maze.
+	offset = get32(g->pack + PACKHEAD + (lo * PACKINDEX) + 4);
+	if ((offset > g->packBytes) || ((g->packBytes - offset) < PACKLEVEL)) { return NULL; }
+	p = g->pack + offset;
+	size = get32(p + 8);
+	row = get32(p + 12);
+	if ((size < 5) || (size > 0xFFFF) || (row < ((size + 7) / 8)) || (row > ROWBYTES(size)) ||
+		(((uint64_t)size * row) > (g->packBytes - offset - PACKLEVEL)) ||
+		(get32(p + 16) >= size) || (get32(p + 20) >= size) || (get32(p + 24) >= size) || (get32(p + 28) >= size))
+	{
+		return NULL;
+	}
+	return p;
+}
+
+// Point maze m at the level in the open pack, return false if the pack doesn't have it.
+static bool packMaze(struct game* g, struct maze* m, unsigned int lvl)
+{
+	const unsigned char* p = packFind(g, lvl);	// Level's header in the pack.
+
+	if (p == NULL) { return false; }
+
+	m->cells = (unsigned char*)(p + PACKLEVEL);
+	m->Msize = get32(p + 8);
+	m->Mrows = m->Msize;
+	m->rowBytes = get32(p + 12);
+	m->exitX = get32(p + 16);
+	m->exitY = get32(p + 20);
+	m->level = lvl;
+	m->seed = get32(p + 4);
+	m->mode = MODENORMAL;
+	m->gen = GENCOUNT;
+	m->candidates = g->candidates;
+	m->ready = true;
+	memset(&m->stats, 0, sizeof(m->stats));
+	m->toExit = NULL;
+	m->visited = NULL;
+	if (arenaReset(m, toExitBytes(m->Msize, m->Mrows)) == true) { measureToExit(m); }
+	g->packStartX = get32(p + 24);
+	g->packStartY = get32(p + 28);
+	return true;
+}
+
+// Arena bytes needed to generate a maze of the shape given of size blocks along each side.
+static size_t mazeBytes(mazemode_t shape, unsigned int size)
+{
+	unsigned int cells = (size * BLKSIZE) + MAZEBORDER + MAZEBORDER;	// Cells along each side.
+	size_t blocks = (size_t)size * size;								// Building blocks in the maze.
+	size_t work, search;												// Working memory for the generators and exit search.
+
+	// Open world mode only has the chunks kept.
+	if (shape == MODEWORLD) { return CHUNKCACHE * ((sizeof(struct chunk) + 7) & ~(size_t)7); }
+
+	// Long corridor mode only has the ring buffer and the sets for one row of blocks.
+	if (shape == MODECORRIDOR)
+	{
+		return ((size_t)RINGBLKS * BLKSIZE * ROWBYTES(cells)) +
+			   (((size_t)size * sizeof(unsigned int) + 7) & ~(size_t)7) +
+			   ((((size_t)size + 7) & ~(size_t)7) * 2);
+	}
+
+	// The bit array for the maze, plus the most working memory any generator uses while building it
+	// (Kruskal's three unsigned ints and a byte per block, which also covers joining up the parts after it), or the
+	// exit search uses after that (an unsigned int and a bit per cell), or the distances to the exit and the queue to work
+	// them out (two unsigned ints per cell), whichever is more. Each is rounded up to the arena alignment.
+	work = ((blocks * sizeof(unsigned int) + 7) & ~(size_t)7) +
+		   ((blocks * 2 * sizeof(unsigned int) + 7) & ~(size_t)7) +
+		   ((blocks + 7) & ~(size_t)7);
+	search = (((size_t)cells * cells * sizeof(unsigned int) + 7) & ~(size_t)7) +
+			 ((size_t)cells * ROWBYTES(cells));
+	if (search < toExitBytes(cells, cells)) { search = toExitBytes(cells, cells); }
+	return ((size_t)cells * ROWBYTES(cells)) + ((work > search) ? work : search);
+}
+
+// Copy a building block tile into the maze with its centre at x, y, a whole row of the tile at a time.
+static void stampTile(struct maze* m, unsigned int x, unsigned int y, const struct tile* t)
+{
+	unsigned char* row;		// Row of the maze.
+
+	for (unsigned int yi = 0; yi < BLKSIZE; yi++)
+	{
+		row = mazeRow(m, y - (BLKSIZE / 2) + yi);
+		if (row == NULL) { continue; }
+		bitSetRun(row, x - (BLKSIZE / 2), t->rows[(yi < (BLKSIZE / 2)) ? 0 : ((yi == (BLKSIZE / 2)) ? 1 : 2)], BLKSIZE);
+	}
+}
+
+// Carve a passage from the block at bx, by to the next block in direction d.
+// Direction 1=North(up), 2=East(right), 3=South(down), 4=West(left), the same as the player direction.
+static void openPassage(struct maze* m, unsigned int bx, unsigned int by, unsigned int d)
+{
+	unsigned int x = MAZEBORDER + (bx * BLKSIZE) + (BLKSIZE / 2);	// Centre of the block in the maze.
+	unsigned int y = MAZEBORDER + (by * BLKSIZE) + (BLKSIZE / 2);
+	unsigned char* row;												// Row of a passage going east or west.
+
+	// Open both centres and all the cells between them. Passages along a row are opened a byte at a time.
+	if ((d == 2) || (d == 4))
+	{
+		row = mazeRow(m, y);
+		if (row != NULL) { bitOpenRun(row, (d == 2) ? x : x - BLKSIZE, (d == 2) ? x + BLKSIZE : x); }
+		return;
+	}
+	for (unsigned int i = 0; i <= BLKSIZE; i++)
+	{
+		setCell(m, x, (d == 1) ? y - i : y + i, ' ');
+	}
+}
+
+// Get the block next to block b in direction d (as openPassage), or UINT_MAX if that would be outside of the maze.
+static unsigned int nextBlock(unsigned int b, unsigned int d, unsigned int size)
+{
+	switch (d)
+	{
+		case 1:  { return (b >= size) ? b - size : UINT_MAX; }
+		case 2:  { return ((b % size) < size - 1) ? b + 1 : UINT_MAX; }
+		case 3:  { return (b < (size * (size - 1))) ? b + size : UINT_MAX; }
+		default: { return ((b % size) > 0) ? b - 1 : UINT_MAX; }
+	}
+}
+
+// Original maze generator, building the maze from random building block tiles.
+static void genBlocks(struct maze* m, unsigned int size)
+{
+	unsigned int sel;		// Variable used for random numbers when constructing the maze.
+	unsigned int* work;		// Worklist of blocks that have an open corridor leading into them, waiting to be filled.
+	unsigned int count = 0;	// Number of blocks in the worklist.
+	unsigned char* queued;	// Flag for each block, 1 once it has been put on the worklist so it is only visited once, 2 once built.
+	unsigned int bx, by;	// Block position in the maze.
+	unsigned int x, y;		// Centre of the block in the maze.
+	unsigned int need, w;	// Sides that corridors lead in from, and the sides of the tile used.
+	unsigned int shut;		// Sides that can't lead on to a new block.
+	unsigned int last;		// 1 while the worklist is short, to pick from the tiles that lead on.
+
+	work = arenaAlloc(m, (size_t)size * size * sizeof(unsigned int));
+	queued = arenaAlloc(m, (size_t)size * size);
+	memset(queued, 0, (size_t)size * size);
+
+	// The first block goes in the top left corner, it has no connection yet.
+	work[count++] = 0;
+	queued[0] = 1;
+
+// The maze is built from a worklist of blocks that have an open corridor leading into them. A block is taken from a random
+// place in the worklist, a tile that joins every corridor leading into it is put in it, then any unused blocks that its corridors
+// lead into are added to the worklist. Each block is only ever added once, so the maze is built in a single pass however big it is.
+// Blocks that no corridor ever leads into are left solid, joinBlocks joins them on afterwards.
+	while (count > 0)
+	{
+		// Take a random block from the worklist, moving the last one into its place.
+		sel = rngRange(&m->rng, count);
+		bx = work[sel] % size;
+		by = work[sel] / size;
+		work[sel] = work[--count];
+
+		// The offset of border and blksize is to get the middle of the building block.
+		x = MAZEBORDER + (bx * BLKSIZE) + (BLKSIZE / 2);
+		y = MAZEBORDER + (by * BLKSIZE) + (BLKSIZE / 2);
+
+		// Find the sides that corridors lead in from, and the sides that can't lead anywhere as they are at the edge of the
+		// maze or next to a block that is already built. Then pick a tile from the ones listed for the sides leading in,
+		// and close off any sides that can't lead anywhere.
+		need = 0;
+		if (getCell(m, x, y - (BLKSIZE / 2) - 1) == ' ') { need |= TILEN; }
+		if (getCell(m, x + (BLKSIZE / 2) + 1, y) == ' ') { need |= TILEE; }
+		if (getCell(m, x, y + (BLKSIZE / 2) + 1) == ' ') { need |= TILES; }
+		if (getCell(m, x - (BLKSIZE / 2) - 1, y) == ' ') { need |= TILEW; }
+		shut = 0;
+		if ((by == 0) || (queued[((by - 1) * size) + bx] == 2)) { shut |= TILEN; }
+		if ((bx == size - 1) || (queued[(by * size) + bx + 1] == 2)) { shut |= TILEE; }
+		if ((by == size - 1) || (queued[((by + 1) * size) + bx] == 2)) { shut |= TILES; }
+		if ((bx == 0) || (queued[(by * size) + bx - 1] == 2)) { shut |= TILEW; }
+		last = (count < TILELEADON) ? 1 : 0;
+		w = tileChoice[last][need][rngRange(&m->rng, tileChoices[last][need])] & ~(shut & ~need);
+		stampTile(m, x, y, &tiles[w]);
+		queued[(by * size) + bx] = 2;
+
+		// Add any unused blocks that the new corridors lead into to the worklist.
+		if (((w & TILEW) != 0) && (queued[(by * size) + bx - 1] == 0))
+		{
+			queued[(by * size) + bx - 1] = 1;
+			work[count++] = (by * size) + bx - 1;
+		}
+		if (((w & TILEE) != 0) && (queued[(by * size) + bx + 1] == 0))
+		{
+			queued[(by * size) + bx + 1] = 1;
+			work[count++] = (by * size) + bx + 1;
+		}
+		if (((w & TILEN) != 0) && (queued[((by - 1) * size) + bx] == 0))
+		{
+			queued[((by - 1) * size) + bx] = 1;
+			work[count++] = ((by - 1) * size) + bx;
+		}
+		if (((w & TILES) != 0) && (queued[((by + 1) * size) + bx] == 0))
+		{
+			queued[((by + 1) * size) + bx] = 1;
+			work[count++] = ((by + 1) * size) + bx;
+		}
+	}
+}
+
+// Recursive backtracker, a random walk that backs up to the last junction when it gets stuck.
+// Makes long winding corridors with few branches. A stack is used rather than recursion, so big mazes can't overflow.
+static void genBacktrack(struct maze* m, unsigned int size)
+{
+	unsigned int* stack;		// Path of blocks back to the start.
+	unsigned int count = 0;		// Number of blocks on the stack.
+	unsigned char* visited;		// Flag for each block once it is part of the maze.
+	unsigned int b, n, d;		// Current block, next block and direction.
+	unsigned int dirs[4];		// Directions that lead to unvisited blocks.
+	unsigned int ndirs;			// Number of directions found.
+
+	stack = arenaAlloc(m, (size_t)size * size * sizeof(unsigned int));
+	visited = arenaAlloc(m, (size_t)size * size);
+	memset(visited, 0, (size_t)size * size);
+
+	visited[0] = 1;
+	stack[count++] = 0;
+	setCell(m, MAZEBORDER + (BLKSIZE / 2), MAZEBORDER + (BLKSIZE / 2), ' ');
+
+	while (count > 0)
+	{
+		b = stack[count - 1];
+
+		// Find the directions that lead to blocks not yet visited.
+		ndirs = 0;
+		for (d = 1; d <= 4; d++)
+		{
+			n = nextBlock(b, d, size);
+			if ((n != UINT_MAX) && (visited[n] == 0)) { dirs[ndirs++] = d; }
+		}
+
+		if (ndirs == 0)
+		{
+			count--;	// Dead end, back up to try again from the previous block.
+		}
+		else
+		{
+			d = dirs[rngRange(&m->rng, ndirs)];
+			n = nextBlock(b, d, size);
+			openPassage(m, b % size, b / size, d);
+			visited[n] = 1;
+			stack[count++] = n;
+		}
+	}
+}
+
+// Find the set that block b is in, for Kruskal's algorithm. Halves the path to the root on the way, so later finds are quicker.
+static unsigned int findSet(unsigned int* parent, unsigned int b)
+{
+	while (parent[b] != b)
+	{
+		parent[b] = parent[parent[b]];
+		b = parent[b];
+	}
+	return b;
+}
+
+// Kruskal's algorithm, opening walls in a random order as long as they join two separate parts of the maze.
+// Union-find keeps track of which blocks are already joined. Makes lots of short dead ends.
+static void genKruskal(struct maze* m, unsigned int size)
+{
+	unsigned int* parent;		// Union-find parent of each block.
+	unsigned int* walls;		// Every wall between blocks, block * 2 for the east wall and block * 2 + 1 for the south wall.
+	unsigned int count = 0;		// Number of walls.
+	unsigned int w, b, n, d;	// Wall, block, next block and direction.
+	unsigned int rb, rn;		// Sets of the two blocks.
+
+	parent = arenaAlloc(m, (size_t)size * size * sizeof(unsigned int));
+	walls = arenaAlloc(m, (size_t)size * size * 2 * sizeof(unsigned int));
+
+	for (b = 0; b < size * size; b++)
+	{
+		parent[b] = b;
+		if ((b % size) < size - 1) { walls[count++] = b * 2; }
+		if (b < size * (size - 1)) { walls[count++] = (b * 2) + 1; }
+	}
+
+	// Shuffle the walls, so they are opened in a random order.
+	for (unsigned int i = count - 1; i > 0; i--)
+	{
+		n = rngRange(&m->rng, i + 1);
+		w = walls[i];
+		walls[i] = walls[n];
+		walls[n] = w;
+	}
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		b = walls[i] / 2;
+		d = (walls[i] & 1) ? 3 : 2;
+		n = nextBlock(b, d, size);
+		rb = findSet(parent, b);
+		rn = findSet(parent, n);
+		if (rb != rn)
+		{
+			parent[rb] = rn;
+			openPassage(m, b % size, b / size, d);
+		}
+	}
+}
+
+// Count the cells that would need opening to carve a passage from the block at bx, by to the next block in direction d
+// (east or south). These are the same cells as openPassage opens, so 0 means the blocks are already joined. The bits are
+// looked at directly, as getCell is slower and there is no exit yet.
+static unsigned int passageCost(struct maze* m, unsigned int bx, unsigned int by, unsigned int d)
+{
+	unsigned int x = MAZEBORDER + (bx * BLKSIZE) + (BLKSIZE / 2);	// Centre of the block in the maze.
+	unsigned int y = MAZEBORDER + (by * BLKSIZE) + (BLKSIZE / 2);
+	size_t n = (((size_t)y * m->rowBytes) << 3) + x;				// Bit for the centre cell.
+	size_t step = (d == 2) ? 1 : ((size_t)m->rowBytes << 3);		// Bits between one cell and the next.
+	unsigned int cost = 0;
+
+	for (unsigned int i = 0; i <= BLKSIZE; i++, n += step)
+	{
+		cost += (m->cells[n >> 3] >> (n & 7)) & 1;
+	}
+	return cost;
+}
+
+// Join every part of the maze together, so that no block is left that can't be reached from the start. Union-find puts
+// blocks with a passage between them in the same part. Then walls between blocks in different parts are opened cheapest
+// first (the fewest cells to open), as long as they still join two separate parts, the same as Kruskal's algorithm does.
+// Costs are only 1 to BLKSIZE + 1 cells, so the walls are sorted by counting and it all takes time in line with the maze
+// size. Blocks that were never used are solid, so they become short dead ends. Returns the number of walls opened.
+static unsigned int joinBlocks(struct maze* m, unsigned int size)
+{
+	unsigned int* parent;				// Union-find parent of each block.
+	unsigned int* walls;				// Walls between parts, block * 2 for the east wall and block * 2 + 1 for the south wall.
+	unsigned int start[BLKSIZE + 3];	// Number of walls of each cost, then where each cost starts in walls.
+	unsigned int b, n, d, c;			// Block, next block, direction and cost.
+	unsigned int rb, rn;				// Parts of the two blocks.
+	unsigned int repairs = 0;			// Walls opened.
+
+	parent = arenaAlloc(m, (size_t)size * size * sizeof(unsigned int));
+	walls = arenaAlloc(m, (size_t)size * size * 2 * sizeof(unsigned int));
+	memset(start, 0, sizeof(start));
+
+	// Put blocks that are already joined in the same part.
+	for (b = 0; b < size * size; b++) { parent[b] = b; }
+	for (b = 0; b < size * size; b++)
+	{
+		for (d = 2; d <= 3; d++)
+		{
+			n = nextBlock(b, d, size);
+			if ((n == UINT_MAX) || (passageCost(m, b % size, b / size, d) != 0)) { continue; }
+			rb = findSet(parent, b);
+			rn = findSet(parent, n);
+			if (rb != rn) { parent[rb] = rn; }
+		}
+	}
+
+	// Count the walls of each cost between blocks in different parts, then sort them by cost.
+	for (unsigned int pass = 0; pass < 2; pass++)
+	{
+		for (b = 0; b < size * size; b++)
+		{
+			for (d = 2; d <= 3; d++)
+			{
+				n = nextBlock(b, d, size);
+				if ((n == UINT_MAX) || (findSet(parent, b) == findSet(parent, n))) { continue; }
+				c = passageCost(m, b % size, b / size, d);
+				if (pass == 0) { start[c + 1]++; }
+				else { walls[start[c]++] = (b * 2) + (d - 2); }
+			}
+		}
+		if (pass == 0)
+		{
+			for (c = 1; c < BLKSIZE + 3; c++) { start[c] += start[c - 1]; }
+		}
+	}
+
+	// Open the cheapest walls that join separate parts, until there is only one part. start[BLKSIZE + 1] is now the
+	// number of walls.
+	for (unsigned int i = 0; i < start[BLKSIZE + 1]; i++)
+	{
+		b = walls[i] / 2;
+		d = (walls[i] & 1) ? 3 : 2;
+		n = nextBlock(b, d, size);
+		rb = findSet(parent, b);
+		rn = findSet(parent, n);
+		if (rb != rn)
+		{
+			parent[rb] = rn;
+			openPassage(m, b % size, b / size, d);
+			repairs++;
+		}
+	}
+	return repairs;
+}
+
+// Wilson's algorithm, random walks from each block not yet in the maze until they hit the maze, with any loops removed.
+// The mazes are picked evenly from all possible mazes, so have no bias towards any style.
+static void genWilson(struct maze* m, unsigned int size)
+{
+	unsigned char* inMaze;		// Flag for each block once it is part of the maze.
+	unsigned char* way;			// Direction last taken out of each block by the current walk. Later visits overwrite
+								// earlier ones, which is what removes the loops.
+	unsigned int b, n, d;		// Block, next block and direction.
+
+	inMaze = arenaAlloc(m, (size_t)size * size);
+	way = arenaAlloc(m, (size_t)size * size);
+	memset(inMaze, 0, (size_t)size * size);
+
+	inMaze[0] = 1;
+	setCell(m, MAZEBORDER + (BLKSIZE / 2), MAZEBORDER + (BLKSIZE / 2), ' ');
+
+	for (unsigned int start = 1; start < size * size; start++)
+	{
+		if (inMaze[start] != 0) { continue; }
+
+		// Walk randomly until the maze is reached, remembering the way out of each block.
+		b = start;
+		while (inMaze[b] == 0)
+		{
+			do
+			{
+				d = rngRange(&m->rng, 4) + 1;
+				n = nextBlock(b, d, size);
+			} while (n == UINT_MAX);
+			way[b] = (unsigned char)d;
+			b = n;
+		}
+
+		// Follow the remembered way from the start again, adding the loop-free path to the maze.
+		b = start;
+		while (inMaze[b] == 0)
+		{
+			inMaze[b] = 1;
+			openPassage(m, b % size, b / size, way[b]);
+			b = nextBlock(b, way[b], size);
+		}
+	}
+}
+
+// Prim's algorithm, growing the maze by joining a random block from the edge of the maze to a block already in the maze.
+// Makes many short branches radiating out from the start.
+static void genPrim(struct maze* m, unsigned int size)
+{
+	unsigned int* edge;			// Blocks next to the maze, that are not yet part of it.
+	unsigned int count = 0;		// Number of blocks in the edge list.
+	unsigned char* state;		// 0 not yet reached, 1 in the edge list, 2 in the maze.
+	unsigned int b, n, d, sel;	// Block, next block, direction and random selection.
+	unsigned int dirs[4];		// Directions that lead back into the maze.
+	unsigned int ndirs;			// Number of directions found.
+
+	edge = arenaAlloc(m, (size_t)size * size * sizeof(unsigned int));
+	state = arenaAlloc(m, (size_t)size * size);
+	memset(state, 0, (size_t)size * size);
+
+	b = 0;
+	setCell(m, MAZEBORDER + (BLKSIZE / 2), MAZEBORDER + (BLKSIZE / 2), ' ');
+	for (;;)
+	{
+		// Put block b in the maze and add its neighbours to the edge list.
+		state[b] = 2;
+		for (d = 1; d <= 4; d++)
+		{
+			n = nextBlock(b, d, size);
+			if ((n != UINT_MAX) && (state[n] == 0))
+			{
+				state[n] = 1;
+				edge[count++] = n;
+			}
+		}
+		if (count == 0) { break; }
+
+		// Take a random block from the edge list, moving the last one into its place.
+		sel = rngRange(&m->rng, count);
+		b = edge[sel];
+		edge[sel] = edge[--count];
+
+		// Join it to a random neighbour that is already in the maze.
+		ndirs = 0;
+		for (d = 1; d <= 4; d++)
+		{
+			n = nextBlock(b, d, size);
+			if ((n != UINT_MAX) && (state[n] == 2)) { dirs[ndirs++] = d; }
+		}
+		openPassage(m, b % size, b / size, dirs[rngRange(&m->rng, ndirs)]);
+	}
+}
+
+// Make the next row of blocks for long corridor mode with Eller's algorithm, overwriting the oldest row in the ring buffer.
+// Blocks next to each other in different sets are randomly joined, then passages are made down to the next row. Blocks without
+// a passage from above start new sets. Plain Eller's only needs a passage down for each set, but the way to it could then go
+// back up into rows that have been overwritten. Giving every run of joined blocks a passage down means the player can always
+// carry on south from anywhere, so they can never get shut in by the rows behind them being dropped.
+// Blocks in the same set are sometimes joined too. Otherwise once every block went down in one set no block could ever be
+// joined again, and the rest of the maze would be straight corridors going south. The loops this makes don't matter, as the
+// rows behind the player are dropped anyway. The exit row has no passages down and every row after it is all blocks,
+// so the maze ends there and the player can't walk past the exit.
+static void makeRow(struct maze* m, unsigned int size)
+{
+	unsigned int y = MAZEBORDER + (m->nextRow * BLKSIZE) + (BLKSIZE / 2);	// Centre row of the blocks.
+	unsigned int x;				// Centre of a block.
+	unsigned int from, to;		// Sets being joined.
+	unsigned int spare = 0;		// Next set number to check for being free.
+	unsigned int c, sel;		// Block in the row and random selection.
+	unsigned int run = 0;		// First block in the current run of joined blocks.
+	bool down = false;			// Set once the current run has a passage down.
+	bool last;					// Row with the exit, where every block is joined so the exit can be reached.
+	bool join;					// Join the block to the one to the east.
+
+	// Clear the rows in the ring buffer for the new row of blocks. Rows after the exit are left as blocks.
+	memset(m->cells + ((m->nextRow % RINGBLKS) * BLKSIZE * m->rowBytes), 0xFF, BLKSIZE * m->rowBytes);
+	m->nextRow++;
+	if ((m->nextRow - 1) > m->exitRow) { return; }
+	last = ((m->nextRow - 1) == m->exitRow);
+
+	// Blocks with a passage from above stay in their set, others go into sets that aren't in use.
+	memset(m->setFlag, 0, size);
+	for (c = 0; c < size; c++)
+	{
+		if ((m->rowDown[c] != 0) && (m->nextRow > 1)) { m->setFlag[m->rowSet[c]] = 1; }
+	}
+	for (c = 0; c < size; c++)
+	{
+		x = MAZEBORDER + (c * BLKSIZE) + (BLKSIZE / 2);
+		setCell(m, x, y, ' ');
+		if ((m->rowDown[c] != 0) && (m->nextRow > 1))
+		{
+			setCell(m, x, y - 1, ' ');		// Bottom of the block above was opened when it was made.
+		}
+		else
+		{
+			while (m->setFlag[spare] != 0) { spare++; }
+			m->setFlag[spare] = 1;
+			m->rowSet[c] = spare;
+		}
+	}
+
+	// Randomly join blocks to the east, less often if they are already in the same set. On the exit row every block is
+	// joined, so that the exit can be reached along the row whichever way the player arrives.
+	// setFlag is re-used to remember which blocks were joined to the east.
+	for (c = 0; c < size - 1; c++)
+	{
+		m->setFlag[c] = 0;
+		if (last == true) { join = true; }
+		else if (m->rowSet[c] != m->rowSet[c + 1]) { join = (rngRange(&m->rng, 2) == 0); }
+		else { join = (rngRange(&m->rng, SAMESETJOIN) == 0); }
+		if (join == true)
+		{
+			openPassage(m, c, m->nextRow - 1, 2);
+			m->setFlag[c] = 1;
+			from = m->rowSet[c + 1];
+			to = m->rowSet[c];
+			for (unsigned int i = 0; i < size; i++)
+			{
+				if (m->rowSet[i] == from) { m->rowSet[i] = to; }
+			}
+		}
+	}
+	m->setFlag[size - 1] = 0;
+
+	// Randomly pick passages down, then make sure each run of joined blocks has at least one. The exit row has none.
+	for (c = 0; (c < size) && (last == false); c++)
+	{
+		m->rowDown[c] = (unsigned char)(rngRange(&m->rng, 2) == 0);
+		if (m->rowDown[c] != 0) { down = true; }
+
+		// At the end of a run, if it has no passage down pick one of its blocks to have one.
+		if (m->setFlag[c] == 0)
+		{
+			if (down == false) { m->rowDown[run + rngRange(&m->rng, c + 1 - run)] = 1; }
+			run = c + 1;
+			down = false;
+		}
+	}
+
+	// Put the exit at the bottom of a block in the exit row, so it is a turning off the corridor.
+	if (last == true)
+	{
+		memset(m->rowDown, 0, size);
+		sel = rngRange(&m->rng, size);
+		setCell(m, MAZEBORDER + (sel * BLKSIZE) + (BLKSIZE / 2), y + 1, 'E');
+	}
+
+	for (c = 0; c < size; c++)
+	{
+		if (m->rowDown[c] != 0)
+		{
+			setCell(m, MAZEBORDER + (c * BLKSIZE) + (BLKSIZE / 2), y + 1, ' ');
+		}
+	}
+}
+
+// Make sure the rows of blocks ahead of row y (where the player is) are in the ring buffer for long corridor mode.
+static void makeRowsAhead(struct maze* m, unsigned int y)
+{
+	unsigned int size = (m->Msize - MAZEBORDER - MAZEBORDER) / BLKSIZE;	// Blocks across the maze.
+	unsigned int blkRow = (y - MAZEBORDER) / BLKSIZE;					// Row of blocks the player is in.
+
+	while (m->nextRow <= (blkRow + AHEADBLKS))
+	{
+		makeRow(m, size);
+	}
+}
+
+// Mix the world seed of maze m with a chunk position and a purpose, giving a random looking number that is always the same for them.
+static unsigned int worldHash(struct maze* m, unsigned int cx, unsigned int cy, unsigned int salt)
+{
+	unsigned int h = m->worldSeed ^ (cx * 0x9E3779B1u) ^ (cy * 0x85EBCA77u) ^ (salt * 0xC2B2AE3Du);
+
+	h ^= h >> 16;
+	h *= 0x7FEB352Du;
+	h ^= h >> 15;
+	h *= 0x846CA68Bu;
+	h ^= h >> 16;
+	return h;
+}
+
+// Get a cell in a chunk, true if it is a block.
+static bool chunkWall(struct chunk* ch, unsigned int x, unsigned int y)
+{
+	return (ch->cells[y][x >> 3] & (1u << (x & 7))) != 0;
+}
+
+// Check if a wall cell of a chunk can have the exit put in it. It must be inside the chunk's edge, so every cell next
+// to it is in the chunk, and only one space can be next to it, so the exit can only be reached from there.
+static bool chunkExitWall(struct chunk* ch, unsigned int x, unsigned int y)
+{
+	if ((x < 1) || (y < 1) || (x >= CHUNKCELLS - 1) || (y >= CHUNKCELLS - 1) || (chunkWall(ch, x, y) == false)) { return false; }
+	return ((chunkWall(ch, x - 1, y) == false) + (chunkWall(ch, x + 1, y) == false) +
+			(chunkWall(ch, x, y - 1) == false) + (chunkWall(ch, x, y + 1) == false)) == 1;
+}
+
+// Open len cells in a chunk going in direction d (as openPassage) from x, y, including x, y.
+static void chunkOpen(struct chunk* ch, unsigned int x, unsigned int y, unsigned int d, unsigned int len)
+{
+	if ((d == 2) || (d == 4))
+	{
+		bitOpenRun(ch->cells[y], (d == 2) ? x : x - (len - 1), (d == 2) ? x + (len - 1) : x);
+		return;
+	}
+	for (unsigned int i = 0; i < len; i++)
+	{
+		ch->cells[y][x >> 3] &= (unsigned char)~(1u << (x & 7));
+		switch (d)
+		{
+			case 1:  { y--; break; }
+			case 2:  { x++; break; }
+			case 3:  { y++; break; }
+			default: { x--; break; }
+		}
+	}
+}
+
+// Make the chunk at cx, cy. Inside the chunk it is a recursive backtracker maze, using a random sequence from the world seed
+// and the chunk position. Each edge then gets a passage through to the next chunk. The passage for an edge is decided by the
+// chunk to the west or north of it, so both chunks agree on where it is. As every chunk is joined to all four of its
+// neighbours, every part of the world can be reached.
+static void makeChunk(struct maze* m, struct chunk* ch, unsigned int cx, unsigned int cy)
+{
+	unsigned char stack[CHUNKBLKS * CHUNKBLKS];		// Path of blocks back to the start.
+	unsigned char visited[CHUNKBLKS * CHUNKBLKS];	// Flag for each block once it is part of the maze.
+	unsigned int count = 0;		// Number of blocks on the stack.
+	struct rng rnd;				// Random numbers for this chunk.
+	unsigned int b, n, d;		// Current block, next block and direction.
+	unsigned int dirs[4];		// Directions that lead to unvisited blocks.
+	unsigned int ndirs;			// Number of directions found.
+	unsigned int x, y;			// Centre of a block in the chunk.
+	unsigned int ex, ey = 0;	// Exit position in the chunk, if it is in this chunk.
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for directions 1=North(up), 2=East(right), 3=South(down), 4=West(left).
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+
+	ch->cx = cx;
+	ch->cy = cy;
+	ch->valid = true;
+	memset(ch->cells, 0xFF, sizeof(ch->cells));
+	memset(visited, 0, sizeof(visited));
+	rngSeed(&rnd, worldHash(m, cx, cy, 0));
+
+	visited[0] = 1;
+	stack[count++] = 0;
+	chunkOpen(ch, BLKSIZE / 2, BLKSIZE / 2, 2, 1);
+	while (count > 0)
+	{
+		b = stack[count - 1];
+
+		// Find the directions that lead to blocks not yet visited.
+		ndirs = 0;
+		for (d = 1; d <= 4; d++)
+		{
+			n = nextBlock(b, d, CHUNKBLKS);
+			if ((n != UINT_MAX) && (visited[n] == 0)) { dirs[ndirs++] = d; }
+		}
+
+		if (ndirs == 0)
+		{
+			count--;	// Dead end, back up to try again from the previous block.
+		}
+		else
+		{
+			d = dirs[rngRange(&rnd, ndirs)];
+			n = nextBlock(b, d, CHUNKBLKS);
+			chunkOpen(ch, ((b % CHUNKBLKS) * BLKSIZE) + (BLKSIZE / 2), ((b / CHUNKBLKS) * BLKSIZE) + (BLKSIZE / 2), d, BLKSIZE + 1);
+			visited[n] = 1;
+			stack[count++] = (unsigned char)n;
+		}
+	}
+
+	// Passages through each edge, from the centre of the block next to the edge out to the edge.
+	y = ((worldHash(m, cx, cy, 1) % CHUNKBLKS) * BLKSIZE) + (BLKSIZE / 2);
+	chunkOpen(ch, CHUNKCELLS - 1 - (BLKSIZE / 2), y, 2, (BLKSIZE / 2) + 1);		// East.
+	y = ((worldHash(m, cx - 1, cy, 1) % CHUNKBLKS) * BLKSIZE) + (BLKSIZE / 2);
+	chunkOpen(ch, BLKSIZE / 2, y, 4, (BLKSIZE / 2) + 1);							// West.
+	x = ((worldHash(m, cx, cy, 2) % CHUNKBLKS) * BLKSIZE) + (BLKSIZE / 2);
+	chunkOpen(ch, x, CHUNKCELLS - 1 - (BLKSIZE / 2), 3, (BLKSIZE / 2) + 1);		// South.
+	x = ((worldHash(m, cx, cy - 1, 2) % CHUNKBLKS) * BLKSIZE) + (BLKSIZE / 2);
+	chunkOpen(ch, x, BLKSIZE / 2, 1, (BLKSIZE / 2) + 1);							// North.
+
+	if ((cx != m->exitCx) || (cy != m->exitCy)) { return; }
+
+	// Put the exit in the wall to the side of the end of a dead end in this chunk, so that it can't be seen along the
+	// corridor. Every block of a chunk is joined and chunks are joined through their edges, so every space can be reached.
+	// If the edge passages have opened every dead end, put it in any wall beside a corridor, there is always one.
+	ex = UINT_MAX;
+	for (b = 0; (b < CHUNKBLKS * CHUNKBLKS) && (ex == UINT_MAX); b++)
+	{
+		x = ((b % CHUNKBLKS) * BLKSIZE) + (BLKSIZE / 2);
+		y = ((b / CHUNKBLKS) * BLKSIZE) + (BLKSIZE / 2);
+		ndirs = 0;
+		for (d = 1; d <= 4; d++)
+		{
+			if (chunkWall(ch, x + dx[d], y + dy[d]) == false) { ndirs++; n = d; }
+		}
+		if (ndirs != 1) { continue; }
+		for (d = 1; d <= 4; d++)
+		{
+			if (((d % 2) != (n % 2)) && (chunkExitWall(ch, x + dx[d], y + dy[d]) == true))
+			{
+				ex = x + dx[d];
+				ey = y + dy[d];
+				break;
+			}
+		}
+	}
+	for (y = 1; (y < CHUNKCELLS - 1) && (ex == UINT_MAX); y++)
+	{
+		for (x = 1; x < CHUNKCELLS - 1; x++)
+		{
+			if (chunkExitWall(ch, x, y) == true)
+			{
+				ex = x;
+				ey = y;
+				break;
+			}
+		}
+	}
+	m->exitX = (cx * CHUNKCELLS) + ex;
+	m->exitY = (cy * CHUNKCELLS) + ey;
+}
+
+// Find the chunk at cx, cy of maze m for open world mode, making it if it isn't kept. The least recently used chunk makes way for it.
+static struct chunk* getChunk(struct maze* m, unsigned int cx, unsigned int cy)
+{
+	struct chunk* ch = &m->chunks[0];	// Chunk to replace if it isn't found.
+
+	m->chunkClock++;
+	if ((m->lastChunk != NULL) && (m->lastChunk->cx == cx) && (m->lastChunk->cy == cy))
+	{
+		m->lastChunk->used = m->chunkClock;
+		return m->lastChunk;
+	}
+
+	for (unsigned int i = 0; i < CHUNKCACHE; i++)
+	{
+		if (m->chunks[i].valid == false)
+		{
+			if (ch->valid == true) { ch = &m->chunks[i]; }
+		}
+		else if ((m->chunks[i].cx == cx) && (m->chunks[i].cy == cy))
+		{
+			m->chunks[i].used = m->chunkClock;
+			m->lastChunk = &m->chunks[i];
+			return m->lastChunk;
+		}
+		else if ((ch->valid == true) && (m->chunks[i].used < ch->used))
+		{
+			ch = &m->chunks[i];
+		}
+	}
+
+	makeChunk(m, ch, cx, cy);
+	ch->used = m->chunkClock;
+	m->lastChunk = ch;
+	return ch;
+}
+
+// Table of maze generators, in the order of enum MAZEGEN. All of them build into the same maze array.
+static const struct
+{
+	const char* name;					// Name to show the player.
+	void (*generate)(struct maze* m, unsigned int size);	// Function to build maze m of size blocks along each side.
+} generators[GENCOUNT] =
+{
+	{ "Blocks",      genBlocks },
+	{ "Backtracker", genBacktrack },
+	{ "Kruskal",     genKruskal },
+	{ "Wilson",      genWilson },
+	{ "Prim",        genPrim },
+};
+
+// Select the maze generator used from the next maze, a value from enum MAZEGEN.
+void gameSetGenerator(struct game* g, mazegen_t gen)
+{
+	if (gen > GENBYLEVEL) { gen = GENBLOCKS; }
+	g->generator = gen;
+}
+
+// Return the generator selected, a value from enum MAZEGEN.
+mazegen_t gameGetGenerator(struct game* g)
+{
+	return g->generator;
+}
+
+// Return the generator the maze for the game level will be made with, taking turns by level if that is selected, or
+// GENCOUNT if a normal maze for the level comes from the open pack.
+mazegen_t gameGetNextGenerator(struct game* g)
+{
+	if ((g->mode == MODENORMAL) && (packFind(g, g->level) != NULL)) { return GENCOUNT; }
+	if (g->generator >= GENCOUNT) { return (g->level - 1) % GENCOUNT; }
+	return g->generator;
+}
+
+// Return the name of a generator to show the player.
+const char* getGeneratorName(mazegen_t gen)
+{
+	if (gen < GENCOUNT) { return generators[gen].name; }
+	return "By level";
+}
+
+// Check if a wall cell can have the exit put in it beside the dead end at x, y. It must be inside the outer wall and the
+// dead end must be the only space next to it, so the exit can only be reached from the dead end.
+static bool exitWall(struct maze* m, unsigned int x, unsigned int y)
+{
+	if ((x < 1) || (y < 1) || (x >= m->Msize - 1) || (y >= m->Mrows - 1) || (getCell(m, x, y) != '#')) { return false; }
+	return ((getCell(m, x - 1, y) != '#') + (getCell(m, x + 1, y) != '#') +
+			(getCell(m, x, y - 1) != '#') + (getCell(m, x, y + 1) != '#')) == 1;
+}
+
+// Put the exit in maze m, with a breadth first search from the start. The search goes out a step at a time, so each
+// cell's distance along the path from the start is known when it is reached. The exit goes in the wall to the side of
+// the end of the dead end furthest from the start (or with the path nearest to m->exitPath moves if that is set), so
+// that it can't be seen along the corridor. Each cell is looked at once, so this takes time in line with the maze size.
+// The same search measures the maze for m->stats, from how many ways out each space has.
+static void placeExit(struct maze* m)
+{
+	size_t cells = (size_t)m->Msize * m->Mrows;		// Cells in the maze.
+	unsigned int* queue;			// Cells reached, in order of distance from the start.
+	unsigned char* seen;			// Bit for each cell, set once it has been reached.
+	unsigned int head = 0, tail = 0;// Next cell to look at from, and end of the queue.
+	unsigned int layer;				// End of the cells at the current distance in the queue.
+	unsigned int dist = 0;			// Moves from the start to the cells being looked at.
+	unsigned int c, x, y, n;		// Cell, its position and the next cell.
+	unsigned int ways, way;			// Spaces next to a cell and the direction to the last one found.
+	unsigned int ex = 0, ey = 0;	// Best exit position found.
+	unsigned int best = UINT_MAX;	// How far the best exit's path is from what is wanted, UINT_MAX if none found yet.
+	unsigned int fx = 0, fy = 0;	// Exit beside the furthest space with a wall it can go in, if there are no dead ends to use.
+	unsigned int far = 0;			// Moves from the start to that space, 0 if none found yet.
+	unsigned int score;				// How far an exit's path is from what is wanted.
+	unsigned int path = 0;			// Moves from the start to the best exit.
+	unsigned int edges = 0;			// Ways out of every space, each move between spaces is counted from both ends.
+	unsigned int nodeWays = 0;		// Ways out of junctions and dead ends, each corridor is counted from both ends.
+	unsigned int branches = 0;		// Ways on from every junction.
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for directions 1=North(up), 2=East(right), 3=South(down), 4=West(left).
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+
+	queue = arenaAlloc(m, cells * sizeof(unsigned int));
+	seen = arenaAlloc(m, (size_t)m->Mrows * m->rowBytes);
+	memset(seen, 0, (size_t)m->Mrows * m->rowBytes);
+
+	x = MAZEBORDER + (BLKSIZE / 2);
+	y = MAZEBORDER + (BLKSIZE / 2);
+	seen[(y * m->rowBytes) + (x >> 3)] |= (unsigned char)(1u << (x & 7));
+	queue[tail++] = (y * m->Msize) + x;
+	layer = tail;
+
+	while (head < tail)
+	{
+		if (head == layer)
+		{
+			dist++;
+			layer = tail;
+		}
+		c = queue[head++];
+		x = c % m->Msize;
+		y = c / m->Msize;
+
+		// Add the spaces next to this cell that haven't been reached yet. The bits are looked at directly, as getCell
+		// is slower and there is no exit yet. The outer wall means the cells next to a space are always in the maze.
+		ways = 0;
+		way = 0;
+		for (unsigned int d = 1; d <= 4; d++)
+		{
+			n = (((y + dy[d]) * m->rowBytes) << 3) + x + dx[d];		// Bit for the next cell in the maze and seen arrays.
+			if ((m->cells[n >> 3] & (1u << (n & 7))) != 0) { continue; }
+			ways++;
+			way = d;
+			if ((seen[n >> 3] & (1u << (n & 7))) == 0)
+			{
+				seen[n >> 3] |= (unsigned char)(1u << (n & 7));
+				queue[tail++] = c + (dy[d] * (int)m->Msize) + dx[d];
+			}
+		}
+
+		// Count corridors, junctions and dead ends. Corridors run between the spaces that don't have exactly two ways out.
+		edges += ways;
+		if (ways != 2) { nodeWays += ways; }
+		if (ways >= 3)
+		{
+			m->stats.junctions++;
+			branches += ways - 1;
+		}
+		if (ways == 1) { m->stats.deadEnds++; }
+
+		// Keep an exit beside the first space found at each distance that has a wall it can go in, in case no dead end
+		// can be used. Only spaces further out than the last one kept are looked at, so few walls are checked.
+		if ((dist > far) && (best == UINT_MAX))
+		{
+			for (unsigned int side = 1; side <= 4; side++)
+			{
+				if (exitWall(m, x + dx[side], y + dy[side]) == true)
+				{
+					fx = x + dx[side];
+					fy = y + dy[side];
+					far = dist;
+					break;
+				}
+			}
+		}
+
+		// A dead end, other than the start, is somewhere the exit can go. Prefer the furthest, or the nearest to the wanted path.
+		if ((ways != 1) || (dist == 0)) { continue; }
+		score = (m->exitPath == 0) ? UINT_MAX - (dist + 1) :
+				((dist + 1) > m->exitPath) ? (dist + 1) - m->exitPath : m->exitPath - (dist + 1);
+		if (score >= best) { continue; }
+
+		// The exit goes to one side of the end of the dead end, across the way in.
+		for (unsigned int side = 1; side <= 4; side++)
+		{
+			if (((side - way) & 1) == 0) { continue; }
+			if (exitWall(m, x + dx[side], y + dy[side]) == true)
+			{
+				ex = x + dx[side];
+				ey = y + dy[side];
+				best = score;
+				path = dist + 1;
+				break;
+			}
+		}
+	}
+
+	// If there are no dead ends to use, put the exit beside the furthest space that has a wall it can go in, or on the
+	// space furthest from the start if there is none.
+	if ((best == UINT_MAX) && (far > 0))
+	{
+		ex = fx;
+		ey = fy;
+		path = far + 1;
+	}
+	else if (best == UINT_MAX)
+	{
+		ex = queue[tail - 1] % m->Msize;
+		ey = queue[tail - 1] / m->Msize;
+		path = dist;
+	}
+	setCell(m, ex, ey, 'E');
+
+	m->stats.path = path;
+	m->stats.spaces = tail;
+	m->stats.corridor = (nodeWays > 0) ? (float)edges / (float)nodeWays : 0.0f;
+	m->stats.branching = (m->stats.junctions > 0) ? (float)branches / (float)m->stats.junctions : 0.0f;
+}
+
+// Work out how many moves every cell of maze m is from the exit, with a breadth first search out from the exit, so the
+// way to the exit from anywhere is a lookup. The distances are taken from the arena and kept with the maze, the queue
+// after them is only needed while searching. Walls, and spaces the exit can't be reached from, are UINT_MAX.
+static void measureToExit(struct maze* m)
+{
+	size_t cells = (size_t)m->Msize * m->Mrows;		// Cells in the maze.
+	unsigned int* queue;			// Cells reached, in order of distance from the exit.
+	unsigned int head = 0, tail = 0;// Next cell to look at from, and end of the queue.
+	unsigned int c, x, y, n;		// Cell, its position and the bit for the next cell.
+	size_t used;					// Arena used once the distances are taken.
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for directions 1=North(up), 2=East(right), 3=South(down), 4=West(left).
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+
+	m->toExit = arenaAlloc(m, cells * sizeof(unsigned int));
+	used = m->arenaUsed;
+	queue = arenaAlloc(m, cells * sizeof(unsigned int));
+	if ((m->toExit == NULL) || (queue == NULL) || (m->exitX < 1) || (m->exitY < 1) ||
+		(m->exitX >= m->Msize - 1) || (m->exitY >= m->Mrows - 1))
+	{
+		m->toExit = NULL;
+		m->arenaUsed = used;
+		return;
+	}
+	memset(m->toExit, 0xFF, cells * sizeof(unsigned int));
+
+	c = (m->exitY * m->Msize) + m->exitX;
+	m->toExit[c] = 0;
+	queue[tail++] = c;
+	while (head < tail)
+	{
+		c = queue[head++];
+		x = c % m->Msize;
+		y = c / m->Msize;
+
+		// Mazes from a pack could have spaces in the outer wall, don't go out of the maze from them.
+		if ((x < 1) || (y < 1) || (x >= m->Msize - 1) || (y >= m->Mrows - 1)) { continue; }
+
+		// The exit's bit is clear, so the bits can be looked at directly the same as in placeExit.
+		for (unsigned int d = 1; d <= 4; d++)
+		{
+			n = (((y + dy[d]) * m->rowBytes) << 3) + x + dx[d];
+			if ((m->cells[n >> 3] & (1u << (n & 7))) != 0) { continue; }
+			n = c + (dy[d] * (int)m->Msize) + dx[d];
+			if (m->toExit[n] != UINT_MAX) { continue; }
+			m->toExit[n] = m->toExit[c] + 1;
+			queue[tail++] = n;
+		}
+	}
+	m->arenaUsed = used;
+}
+
+// Make maze m for the level, seed, shape and generator set in it. Only the maze itself is used, so this can run on the
+// worker thread while the other maze is played. Long corridor and open world mazes are only started here, as the rest
+// of them is made while they are played.
+static void buildMaze(struct maze* m)
+{
+	unsigned int size;		// Number of building blocks along each side of the maze.
+	size_t used;			// Arena used by the maze array.
+
+	// Start the random numbers for this maze from its seed.
+	rngSeed(&m->rng, m->seed);
+
+	// Set the maze size based on the level. If memory runs out for a very high endless level,
+	// play it on a MAXLEVEL sized maze rather than failing. If even that can't be had, leave the maze empty and not
+	// ready, so everything in it is a block and the player can't move.
+	size = m->level + MAZEADD;
+	if (arenaReset(m, mazeBytes(m->mode, size)) == false)
+	{
+		size = MAXLEVEL + MAZEADD;
+		if (arenaReset(m, mazeBytes(m->mode, size)) == false)
+		{
+			m->cells = NULL;
+			m->chunks = NULL;
+			m->Msize = 0;
+			m->Mrows = 0;
+			m->exitX = UINT_MAX;
+			m->exitY = UINT_MAX;
+			m->toExit = NULL;
+			m->visited = NULL;
+			memset(&m->stats, 0, sizeof(m->stats));
+			m->ready = false;
+			return;
+		}
+	}
+	m->Msize = (size * BLKSIZE) + MAZEBORDER + MAZEBORDER;
+	m->Mrows = m->Msize;
+	m->rowBytes = ROWBYTES(m->Msize);
+	m->exitX = UINT_MAX;
+	m->exitY = UINT_MAX;
+	m->toExit = NULL;
+	m->visited = NULL;
+	memset(&m->stats, 0, sizeof(m->stats));
+
+	if (m->mode == MODECORRIDOR)
+	{
+		// Long corridor mode keeps its rows in a ring buffer, made as the player moves.
+		m->Mrows = UINT_MAX;
+		m->cells = arenaAlloc(m, (size_t)RINGBLKS * BLKSIZE * m->rowBytes);
+	}
+	else if (m->mode == MODEWORLD)
+	{
+		// Open world mode has no edges, the cells are in the chunks.
+		m->Msize = UINT_MAX;
+		m->Mrows = UINT_MAX;
+		m->chunks = arenaAlloc(m, CHUNKCACHE * sizeof(struct chunk));
+	}
+	else
+	{
+		// Take the maze for this level from the arena. The generators take their working lists from the arena after it.
+		m->cells = arenaAlloc(m, (size_t)m->Msize * m->rowBytes);
+
+		// Fill entire maze array with '#'s (all bits set).
+		memset(m->cells, 0xFF, (size_t)m->Msize * m->rowBytes);
+
+		// Joining up any parts that can't be reached and then the exit search re-use the generator's working memory,
+		// it isn't needed once the maze is built.
+		used = m->arenaUsed;
+		generators[m->gen].generate(m, size);
+		m->genBytes = m->arenaPeak - used;
+		m->arenaUsed = used;
+		m->stats.repairs = joinBlocks(m, size);
+		m->arenaUsed = used;
+		placeExit(m);
+		m->arenaUsed = used;
+		measureToExit(m);
+	}
+	m->ready = true;
+}
+
+// Thread to make one of the candidate mazes.
+static void buildCandidate(void* arg)
+{
+	buildMaze((struct maze*)arg);
+}
+
+// How hard a maze is, for picking between candidates. This is how many times the width of the maze the path to the exit
+// winds, so it can be compared across maze sizes.
+static float difficulty(struct maze* m)
+{
+	return (m->Msize > 0) ? (float)m->stats.path / (float)m->Msize : 0.0f;
+}
+
+// Difficulty wanted for a level, going up evenly from TARGETFIRST at level 1 to TARGETLAST at MAXLEVEL.
+static float difficultyTarget(unsigned int lvl)
+{
+	if (lvl > MAXLEVEL) { lvl = MAXLEVEL; }
+	return TARGETFIRST + (((TARGETLAST - TARGETFIRST) * (float)(lvl - 1)) / (float)(MAXLEVEL - 1));
+}
+
+// Make maze m. If more than one candidate is wanted, the candidates are made from different seeds on their own threads
+// at the same time, so they take little longer than one maze on the Wii U's three cores. The threads are pinned to
+// each core in turn from the one after the worker's, which makes the first candidate itself, so more candidates than
+// cores are spread evenly over them. The candidate with the
+// difficulty nearest the level's target is kept. The first candidate is made from the maze's own seed, and the others
+// from seeds that follow from it, so the same seed and number of candidates always gives the same maze.
+static void buildBest(struct game* g, struct maze* m)
+{
+	struct thread threads[MAXCANDIDATES];	// Threads making the other candidates.
+	bool started[MAXCANDIDATES];			// Set for each candidate being made on its own thread.
+	struct maze swap;						// Used to swap the best candidate into m.
+	unsigned int best = 0;					// Best candidate.
+	float target, miss, bestMiss;			// Difficulty wanted and how far candidates are from it.
+
+	if ((m->candidates <= 1) || (m->mode != MODENORMAL))
+	{
+		buildMaze(m);
+		return;
+	}
+
+	for (unsigned int i = 1; i < m->candidates; i++)
+	{
+		started[i] = false;
+		if (g->spares[i] == NULL) { g->spares[i] = calloc(1, sizeof(struct maze)); }
+		if (g->spares[i] == NULL) { continue; }
+
+		g->spares[i]->level = m->level;
+		g->spares[i]->seed = mixSeed(m->seed + i);
+		g->spares[i]->mode = m->mode;
+		g->spares[i]->gen = m->gen;
+		g->spares[i]->exitPath = m->exitPath;
+		g->spares[i]->candidates = 1;
+		g->spares[i]->ready = false;
+		started[i] = startThread(&threads[i], buildCandidate, g->spares[i], (WORKERCORE + i) % threadCores());
+	}
+	buildMaze(m);
+
+	// A candidate that couldn't be made is never picked over one that was.
+	target = difficultyTarget(m->level);
+	bestMiss = (difficulty(m) > target) ? difficulty(m) - target : target - difficulty(m);
+	if (m->ready == false) { bestMiss = FLT_MAX; }
+	for (unsigned int i = 1; i < m->candidates; i++)
+	{
+		if (g->spares[i] == NULL) { continue; }
+		if (started[i] == true) { joinThread(&threads[i]); }
+		else { buildMaze(g->spares[i]); }		// Make it here if its thread couldn't be started.
+		if (g->spares[i]->ready == false) { continue; }
+
+		miss = (difficulty(g->spares[i]) > target) ? difficulty(g->spares[i]) - target : target - difficulty(g->spares[i]);
+		if (miss < bestMiss)
+		{
+			best = i;
+			bestMiss = miss;
+		}
+	}
+
+	// Swap the best candidate into m, arena and all. It keeps the seed and count it was asked for, so it is still
+	// known to be the maze for them.
+	if (best != 0)
+	{
+		swap = *m;
+		*m = *g->spares[best];
+		*g->spares[best] = swap;
+		m->seed = g->spares[best]->seed;
+		m->candidates = g->spares[best]->candidates;
+	}
+}
+
+// Worker thread to make the next level's maze for game arg in the background.
+static void buildAhead(void* arg)
+{
+	buildBest((struct game*)arg, ((struct game*)arg)->ahead);
+}
+
+// Wait for the worker thread to finish making a maze, if it has been started.
+static void joinWorker(struct game* g)
+{
+	if (g->working == true)
+	{
+		joinThread(&g->worker);
+		g->working = false;
+	}
+}
+
+// Start making the next level's maze in the background, with the level and seed it will have when this one is done.
+// If the thread can't be started the next maze is just made when it is needed. There is no need if it is in the pack.
+static void startAhead(struct game* g)
+{
+	g->ahead->level = g->level + 1;
+	if ((g->endless == false) && (g->ahead->level > MAXLEVEL)) { g->ahead->level = MAXLEVEL; }
+	if (packFind(g, g->ahead->level) != NULL) { return; }
+	g->ahead->seed = g->mazeSeed;
+	g->ahead->mode = g->mode;
+	g->ahead->exitPath = g->exitPath;
+	g->ahead->candidates = g->candidates;
+	g->ahead->gen = g->generator;
+	if (g->ahead->gen >= GENCOUNT) { g->ahead->gen = (g->ahead->level - 1) % GENCOUNT; }
+	g->working = startThread(&g->worker, buildAhead, g, WORKERCORE);
+}
+
+// Process to generate the Maze, size (and therefore difficulty) is set by the current game level.
+// Normally the maze has already been made in the background while the last level was played, so it is just swapped in.
+void gameGenerateMaze(struct game* g)
+{
+	unsigned int size;		// Number of building blocks along each side of the maze.
+	mazegen_t gen;			// Generator used for this maze.
+	struct maze* m;			// Used to swap the mazes over.
+	bool fromPack;			// Set if the maze is from the pack.
+
+	// The gameReadLevel function ensures that the level is valid and less the MAXLEVEL (unless in endless mode).
+	// It is kept in memory, so this doesn't wait for the level file.
+	g->level = gameReadLevel(g);
+
+	// Use the selected generator, or take turns through them as the levels go up.
+	gen = g->generator;
+	if (gen >= GENCOUNT) { gen = (g->level - 1) % GENCOUNT; }
+
+	// Levels in an open pack of mazes are played straight from the pack. Otherwise use the maze made in the background
+	// if it is the one wanted, or make it now. Either way the worker has to finish first, it is normally done long before
+	// the player finishes the level.
+	joinWorker(g);
+	fromPack = (g->mode == MODENORMAL) && (packMaze(g, g->cur, g->level) == true);
+	if ((fromPack == false) && (g->ahead->ready == true) && (g->ahead->level == g->level) && (g->ahead->seed == g->mazeSeed) &&
+		(g->ahead->mode == g->mode) && (g->ahead->gen == gen) && (g->ahead->exitPath == g->exitPath) && (g->ahead->candidates == g->candidates))
+	{
+		m = g->cur;
+		g->cur = g->ahead;
+		g->ahead = m;
+	}
+	else if (fromPack == false)
+	{
+		g->cur->level = g->level;
+		g->cur->seed = g->mazeSeed;
+		g->cur->mode = g->mode;
+		g->cur->gen = gen;
+		g->cur->exitPath = g->exitPath;
+		g->cur->candidates = g->candidates;
+		buildBest(g, g->cur);
+	}
+	g->ahead->ready = false;
+
+	// Move the seed on for the next maze.
+	g->mazeSeed = mixSeed(g->mazeSeed);
+
+	// Set the player starting position to the top left of the maze (or where the pack says) and facing east.
+	g->playerX = (fromPack == true) ? g->packStartX : MAZEBORDER + (BLKSIZE / 2);
+	g->playerY = (fromPack == true) ? g->packStartY : MAZEBORDER + (BLKSIZE / 2);
+	g->playerD = 2;
+
+	// If there wasn't the memory to make the maze there is nothing more to set up, it is all blocks.
+	if (g->cur->ready == false) { return; }
+
+	// Long corridor mode only needs the ring buffer and the current row's sets. The rows are made as the player moves.
+	if (g->cur->mode == MODECORRIDOR)
+	{
+		size = (g->cur->Msize - MAZEBORDER - MAZEBORDER) / BLKSIZE;
+		g->cur->rowSet = arenaAlloc(g->cur, (size_t)size * sizeof(unsigned int));
+		g->cur->rowDown = arenaAlloc(g->cur, size);
+		g->cur->setFlag = arenaAlloc(g->cur, size);
+		memset(g->cur->rowDown, 0, size);
+		g->cur->nextRow = 0;
+		g->cur->exitRow = (size * CORRIDORLEN) - 1;
+		makeRowsAhead(g->cur, g->playerY);
+		return;
+	}
+
+	// Open world mode has no edges. The player starts at the top left block of the middle chunk.
+	// Make the chunk with the exit in it, so that the exit position is known from the start.
+	if (g->cur->mode == MODEWORLD)
+	{
+		g->cur->worldSeed = rngNext(&g->cur->rng);
+		for (unsigned int i = 0; i < CHUNKCACHE; i++) { g->cur->chunks[i].valid = false; }
+		g->cur->lastChunk = NULL;
+		g->playerX = (WORLDMID * CHUNKCELLS) + (BLKSIZE / 2);
+		g->playerY = (WORLDMID * CHUNKCELLS) + (BLKSIZE / 2);
+
+		// The exit is further away for each level, in a direction picked from the seed.
+		g->cur->exitCx = WORLDMID + (((worldHash(g->cur, 0, 0, 3) & 1) != 0) ? (g->level + 1) / 2 : -((g->level + 1) / 2));
+		g->cur->exitCy = WORLDMID + (((worldHash(g->cur, 0, 0, 3) & 2) != 0) ? (g->level / 2) + 1 : -((g->level / 2) + 1));
+		getChunk(g->cur, g->cur->exitCx, g->cur->exitCy);
+		return;
+	}
+
+	// Keep track of the cells the player has been in, starting with where they are. The arena always has room for this
+	// after the distances to the exit, as the queue used to work them out isn't needed any more.
+	g->cur->visited = arenaAlloc(g->cur, (size_t)g->cur->Msize * g->cur->rowBytes);
+	if (g->cur->visited != NULL)
+	{
+		memset(g->cur->visited, 0, (size_t)g->cur->Msize * g->cur->rowBytes);
+		setVisited(g->cur, g->playerX, g->playerY);
+	}
+
+	startAhead(g);
+}
+
+// Wait for any maze being made and, for a game keeping the level file, the files queued to be saved in the background,
+// call this before the game exits.
+void gameStopMaze(struct game* g)
+{
+	joinWorker(g);
+	if (g->levelFile == true) { storageFlush(); }
+}
+
+// A snapshot of the level being played, so that it can be carried on later without making the maze again. The file
+// starts with a header (SNAPHEAD bytes: "LSN1", version, the game's level and settings, the maze's shape, size and exit,
+// and the player's position and heading). What follows depends on the shape of maze. A normal maze has its measures, its
+// bit-packed grid and a bit for each cell the player has been in. A long corridor has its random numbers, the rows in
+// its ring buffer and the sets of its current row. An open world only needs its seed and the chunk with the exit, as
+// chunks are always made the same. Numbers are 32-bit, least significant byte first, the same as a pack.
+#define SNAPMAGIC   "LSN1"				// Start of every snapshot file.
+#define SNAPVERSION 1					// Version of the snapshot format.
+#define SNAPHEAD    96					// Bytes of the snapshot header.
+#define SNAPSTATS   32					// Bytes of a normal maze's measures.
+#define SNAPMAX     0x01000000u			// Largest snapshot read, much bigger than any maze needs.
+#define SNAPFILE    "resume.bin"		// Snapshot used when no file is given, in the game's directory.
+
+// Bytes after the header of a snapshot of maze m.
+static size_t snapshotBytes(struct maze* m)
+{
+	size_t grid;		// Bytes of the maze grid.
+	unsigned int size;	// Blocks across a long corridor.
+
+	if (m->mode == MODEWORLD) { return 12; }
+	if (m->mode == MODECORRIDOR)
+	{
+		size = (m->Msize - MAZEBORDER - MAZEBORDER) / BLKSIZE;
+		return 24 + ((size_t)RINGBLKS * BLKSIZE * m->rowBytes) + ((size_t)size * 4) + size;
+	}
+	grid = (size_t)m->Msize * m->rowBytes;
+	return SNAPSTATS + grid + grid;
+}
+
+// Write a snapshot of the level being played to fileName (NULL for resume.bin next to the level file), for loadSnapshot to
+// carry on from. elapsed is kept with it for the caller, such as the time played on the level. The snapshot is written
+// to a temporary file first, so it is never left part written. Return false if there is no maze or writing fails.
+bool gameSaveSnapshot(struct game* g, const char* fileName, unsigned int elapsed)
+{
+	struct maze* m = g->cur;	// Maze being played.
+	unsigned char* buf;			// Snapshot being written.
+	unsigned char* p;			// Next bytes to fill in.
+	size_t bytes;				// Size of the snapshot.
+	size_t grid;				// Bytes of the maze grid.
+	unsigned int size;			// Blocks across a long corridor.
+	uint32_t f;					// A measure's bits.
+	struct storefile* outFile;
+
+	if ((m->ready == false) || (m->mode >= MODECOUNT) || ((m->mode != MODEWORLD) && (m->cells == NULL))) { return false; }
+	bytes = SNAPHEAD + snapshotBytes(m);
+	buf = calloc(1, bytes);
+	if (buf == NULL) { return false; }
+
+	memcpy(buf, SNAPMAGIC, 4);
+	put32(buf + 4, SNAPVERSION);
+	put32(buf + 8, g->level);
+	put32(buf + 12, elapsed);
+	put32(buf + 16, g->endless ? 1 : 0);
+	put32(buf + 20, g->mode);
+	put32(buf + 24, g->generator);
+	put32(buf + 28, g->mazeSeed);
+	put32(buf + 32, g->candidates);
+	put32(buf + 36, g->exitPath);
+	put32(buf + 40, m->mode);
+	put32(buf + 44, m->gen);
+	put32(buf + 48, m->seed);
+	put32(buf + 52, m->candidates);
+	put32(buf + 56, m->exitPath);
+	put32(buf + 60, m->Msize);
+	put32(buf + 64, m->rowBytes);
+	put32(buf + 68, m->exitX);
+	put32(buf + 72, m->exitY);
+	put32(buf + 76, g->playerX);
+	put32(buf + 80, g->playerY);
+	put32(buf + 84, g->playerD);
+	put32(buf + 88, (uint32_t)(bytes - SNAPHEAD));
+	p = buf + SNAPHEAD;
+
+	if (m->mode == MODEWORLD)
+	{
+		put32(p, m->worldSeed);
+		put32(p + 4, m->exitCx);
+		put32(p + 8, m->exitCy);
+	}
+	else if (m->mode == MODECORRIDOR)
+	{
+		size = (m->Msize - MAZEBORDER - MAZEBORDER) / BLKSIZE;
+		for (unsigned int i = 0; i < 4; i++) { put32(p + (i * 4), m->rng.s[i]); }
+		put32(p + 16, m->nextRow);
+		put32(p + 20, m->exitRow);
+		p += 24;
+		memcpy(p, m->cells, (size_t)RINGBLKS * BLKSIZE * m->rowBytes);
+		p += (size_t)RINGBLKS * BLKSIZE * m->rowBytes;
+		for (unsigned int i = 0; i < size; i++) { put32(p + (i * 4), m->rowSet[i]); }
+		memcpy(p + ((size_t)size * 4), m->rowDown, size);
+	}
+	else
+	{
+		grid = (size_t)m->Msize * m->rowBytes;
+		put32(p, m->stats.path);
+		put32(p + 4, m->stats.spaces);
+		put32(p + 8, m->stats.deadEnds);
+		put32(p + 12, m->stats.junctions);
+		memcpy(&f, &m->stats.corridor, 4);
+		put32(p + 16, f);
+		memcpy(&f, &m->stats.branching, 4);
+		put32(p + 20, f);
+		put32(p + 24, m->stats.repairs);
+		memcpy(p + SNAPSTATS, m->cells, grid);
+		if (m->visited != NULL) { memcpy(p + SNAPSTATS + grid, m->visited, grid); }
+	}
+
+	outFile = storageOpen((fileName != NULL) ? fileName : SNAPFILE, true);
+	storageWrite(outFile, buf, bytes);
+	free(buf);
+	return storageCommit(outFile);
+}
+
+// Carry on the level in the snapshot in fileName (NULL for resume.bin next to the level file). The maze is put back as
+// it was, without being made again, along with the player and the game's settings, and elapsed is set to what was kept
+// with it. The snapshot is only used if it is for the level saved, so an old one is never carried on, and it is removed
+// once used. Return false if there isn't a valid snapshot for the level, leaving the game as it was.
+bool gameLoadSnapshot(struct game* g, const char* fileName, unsigned int* elapsed)
+{
+	unsigned char head[SNAPHEAD];	// Snapshot header.
+	unsigned char* buf;				// Rest of the snapshot.
+	const unsigned char* p;			// Next bytes to take.
+	struct maze* m = g->cur;		// Maze the snapshot is put in.
+	struct storefile* inFile;
+	uint32_t lvl, shape, gen, cells, row, bytes;	// Level, shape, generator, size and bytes from the header.
+	uint32_t x, y, d;				// Player position and heading.
+	unsigned int size = 0;			// Blocks across a long corridor.
+	size_t grid = 0;				// Bytes of the maze grid.
+	size_t need;					// Arena needed for the maze.
+	bool endless = g->endless;		// Endless mode before the snapshot.
+	uint32_t f;						// A measure's bits.
+
+	if (fileName == NULL) { fileName = SNAPFILE; }
+	inFile = storageOpen(fileName, false);
+	if (inFile == NULL) { return false; }
+	if (storageRead(inFile, head, SNAPHEAD) != SNAPHEAD)
+	{
+		storageClose(inFile);
+		return false;
+	}
+
+	// Check the header, and that the maze and the player are inside it.
+	lvl = get32(head + 8);
+	shape = get32(head + 40);
+	gen = get32(head + 44);
+	cells = get32(head + 60);
+	row = get32(head + 64);
+	x = get32(head + 76);
+	y = get32(head + 80);
+	d = get32(head + 84);
+	bytes = get32(head + 88);
+	if ((memcmp(head, SNAPMAGIC, 4) != 0) || (get32(head + 4) != SNAPVERSION) || (lvl < 1) ||
+		(get32(head + 20) >= MODECOUNT) || (get32(head + 24) > GENBYLEVEL) || (shape >= MODECOUNT) || (gen > GENCOUNT) ||
+		(get32(head + 32) < 1) || (get32(head + 32) > MAXCANDIDATES) || (d < 1) || (d > 4) || (bytes > SNAPMAX) ||
+		((shape != MODEWORLD) && ((cells < 5) || (cells > 0xFFFF) || (row < ((cells + 7) / 8)) || (row > ROWBYTES(cells)))))
+	{
+		storageClose(inFile);
+		return false;
+	}
+	if (shape == MODECORRIDOR) { size = (cells - MAZEBORDER - MAZEBORDER) / BLKSIZE; }
+	if (shape == MODENORMAL) { grid = (size_t)cells * row; }
+	if ((bytes != ((shape == MODEWORLD) ? 12 :
+				   (shape == MODECORRIDOR) ? 24 + ((size_t)RINGBLKS * BLKSIZE * row) + ((size_t)size * 4) + size :
+				   SNAPSTATS + grid + grid)) ||
+		((shape == MODENORMAL) && ((x >= cells) || (y >= cells) || (get32(head + 68) >= cells) || (get32(head + 72) >= cells))) ||
+		((shape == MODECORRIDOR) && (x >= cells)))
+	{
+		storageClose(inFile);
+		return false;
+	}
+	buf = malloc(bytes);
+	if ((buf == NULL) || (storageRead(inFile, buf, bytes) != bytes))
+	{
+		free(buf);
+		storageClose(inFile);
+		return false;
+	}
+	storageClose(inFile);
+
+	// Only carry on a level that is still the one saved. The saved level depends on endless mode, so use the snapshot's.
+	g->endless = (get32(head + 16) != 0);
+	if (((g->levelFile == true) && (gameReadLevel(g) != lvl)) || ((g->endless == false) && (lvl > MAXLEVEL)))
+	{
+		g->endless = endless;
+		free(buf);
+		return false;
+	}
+
+	// The worker could be making the next maze, and the maze played is about to change.
+	joinWorker(g);
+	need = (shape == MODENORMAL) ? (((grid + 7) & ~(size_t)7) * 2) + toExitBytes(cells, cells) : mazeBytes(shape, size);
+	if (arenaReset(m, need) == false)
+	{
+		g->endless = endless;
+		free(buf);
+		return false;
+	}
+
+	gameWriteLevel(g, lvl);
+	g->mode = get32(head + 20);
+	g->generator = get32(head + 24);
+	g->mazeSeed = get32(head + 28);
+	g->candidates = get32(head + 32);
+	g->exitPath = get32(head + 36);
+
+	m->mode = shape;
+	m->gen = gen;
+	m->seed = get32(head + 48);
+	m->candidates = get32(head + 52);
+	m->exitPath = get32(head + 56);
+	m->level = lvl;
+	m->Msize = cells;
+	m->Mrows = cells;
+	m->rowBytes = row;
+	m->exitX = get32(head + 68);
+	m->exitY = get32(head + 72);
+	m->toExit = NULL;
+	m->visited = NULL;
+	memset(&m->stats, 0, sizeof(m->stats));
+	p = buf;
+
+	if (shape == MODEWORLD)
+	{
+		m->Msize = UINT_MAX;
+		m->Mrows = UINT_MAX;
+		m->chunks = arenaAlloc(m, CHUNKCACHE * sizeof(struct chunk));
+		for (unsigned int i = 0; i < CHUNKCACHE; i++) { m->chunks[i].valid = false; }
+		m->lastChunk = NULL;
+		m->worldSeed = get32(p);
+		m->exitCx = get32(p + 4);
+		m->exitCy = get32(p + 8);
+	}
+	else if (shape == MODECORRIDOR)
+	{
+		m->Mrows = UINT_MAX;
+		for (unsigned int i = 0; i < 4; i++) { m->rng.s[i] = get32(p + (i * 4)); }
+		m->nextRow = get32(p + 16);
+		m->exitRow = get32(p + 20);
+		p += 24;
+		m->cells = arenaAlloc(m, (size_t)RINGBLKS * BLKSIZE * row);
+		memcpy(m->cells, p, (size_t)RINGBLKS * BLKSIZE * row);
+		p += (size_t)RINGBLKS * BLKSIZE * row;
+		m->rowSet = arenaAlloc(m, (size_t)size * sizeof(unsigned int));
+		m->rowDown = arenaAlloc(m, size);
+		m->setFlag = arenaAlloc(m, size);
+		for (unsigned int i = 0; i < size; i++) { m->rowSet[i] = get32(p + (i * 4)) % size; }
+		memcpy(m->rowDown, p + ((size_t)size * 4), size);
+	}
+	else
+	{
+		m->stats.path = get32(p);
+		m->stats.spaces = get32(p + 4);
+		m->stats.deadEnds = get32(p + 8);
+		m->stats.junctions = get32(p + 12);
+		f = get32(p + 16);
+		memcpy(&m->stats.corridor, &f, 4);
+		f = get32(p + 20);
+		memcpy(&m->stats.branching, &f, 4);
+		m->stats.repairs = get32(p + 24);
+		m->cells = arenaAlloc(m, grid);
+		memcpy(m->cells, p + SNAPSTATS, grid);
+		m->visited = arenaAlloc(m, grid);
+		memcpy(m->visited, p + SNAPSTATS + grid, grid);
+		measureToExit(m);
+	}
+	free(buf);
+
+	m->ready = true;
+	g->ahead->ready = false;
+	g->playerX = x;
+	g->playerY = y;
+	g->playerD = d;
+	*elapsed = get32(head + 12);
+	storageRemove(fileName);
+
+	// Make the next level's maze in the background, the same as when the level was started.
+	if (shape == MODENORMAL) { startAhead(g); }
+	return true;
+}
+
+// Remove the snapshot in fileName (NULL for resume.bin next to the level file), when there is no level to carry on.
+void gameClearSnapshot(struct game* g, const char* fileName)
+{
+	(void)g;							// The snapshot is a file, there is nothing in the game to clear.
+	storageRemove((fileName != NULL) ? fileName : SNAPFILE);
+}
+
+// Allocate a game of its own, separate from the default game and any other game. It starts with the same settings as
+// the default game, and keeps its level in memory rather than in the level file. Returns NULL if there is no memory.
+struct game* newGame()
+{
+	struct game* g = calloc(1, sizeof(struct game));
+
+	if (g == NULL) { return NULL; }
+	g->cur = &g->mazes[0];
+	g->ahead = &g->mazes[1];
+	g->mode = MODENORMAL;
+	g->generator = GENBLOCKS;
+	g->mazeSeed = 1;
+	g->candidates = 1;
+	g->levelFile = false;
+	g->playerX = 2;
+	g->playerY = 2;
+	g->playerD = 4;
+	return g;
+}
+
+// Free a game from newGame, waiting for any maze it is making and freeing its mazes and pack.
+void freeGame(struct game* g)
+{
+	if (g == NULL) { return; }
+	joinWorker(g);
+	if (g->levelFile == true) { storageFlush(); }
+	gameClosePack(g);
+	free(g->mazes[0].arena);
+	free(g->mazes[1].arena);
+	for (unsigned int i = 0; i < MAXCANDIDATES; i++) { freeMaze(g->spares[i]); }
+	free(g);
+}
+
+// The functions without a game play the default game, the one the Wii U game uses.
+void generateMaze()
+{
+	gameGenerateMaze(&defaultGame);
+}
+
+void stopMaze()
+{
+	gameStopMaze(&defaultGame);
+}
+
+void setGenerator(mazegen_t gen)
+{
+	gameSetGenerator(&defaultGame, gen);
+}
+
+mazegen_t getGenerator()
+{
+	return gameGetGenerator(&defaultGame);
+}
+
+mazegen_t getNextGenerator()
+{
+	return gameGetNextGenerator(&defaultGame);
+}
+
+unsigned int movePlayer(char move)
+{
+	return gameMovePlayer(&defaultGame, move);
+}
+
+unsigned int getDistanceToExit()
+{
+	return gameGetDistanceToExit(&defaultGame);
+}
+
+unsigned int getHintDirection()
+{
+	return gameGetHintDirection(&defaultGame);
+}
+
+char getSolveMove()
+{
+	return gameGetSolveMove(&defaultGame);
+}
+
+void getPlayerPosition(unsigned int* x, unsigned int* y, unsigned int* d)
+{
+	gameGetPlayerPosition(&defaultGame, x, y, d);
+}
+
+char get2DView(int x, int y)
+{
+	return gameGet2DView(&defaultGame, x, y);
+}
+
+char get3DView(int f, int s)
+{
+	return gameGet3DView(&defaultGame, f, s);
+}
+
+unsigned int getLevel()
+{
+	return gameGetLevel(&defaultGame);
+}
+
+unsigned int getPlayedLevel()
+{
+	return gameGetPlayedLevel(&defaultGame);
+}
+
+unsigned int getPlayedSeed()
+{
+	return gameGetPlayedSeed(&defaultGame);
+}
+
+mazegen_t getPlayedGenerator()
+{
+	return gameGetPlayedGenerator(&defaultGame);
+}
+
+mazemode_t getPlayedMode()
+{
+	return gameGetPlayedMode(&defaultGame);
+}
+
+void setEndless(bool on)
+{
+	gameSetEndless(&defaultGame, on);
+}
+
+bool getEndless()
+{
+	return gameGetEndless(&defaultGame);
+}
+
+void setSeed(unsigned int seed)
+{
+	gameSetSeed(&defaultGame, seed);
+}
+
+unsigned int getSeed()
+{
+	return gameGetSeed(&defaultGame);
+}
+
+void setExitPath(unsigned int moves)
+{
+	gameSetExitPath(&defaultGame, moves);
+}
+
+unsigned int getExitPath()
+{
+	return gameGetExitPath(&defaultGame);
+}
+
+void setCandidates(unsigned int count)
+{
+	gameSetCandidates(&defaultGame, count);
+}
+
+unsigned int getCandidates()
+{
+	return gameGetCandidates(&defaultGame);
+}
+
+void getStats(struct mazestats* stats)
+{
+	gameGetStats(&defaultGame, stats);
+}
+
+void setMode(mazemode_t newMode)
+{
+	gameSetMode(&defaultGame, newMode);
+}
+
+mazemode_t getMode()
+{
+	return gameGetMode(&defaultGame);
+}
+
+unsigned int readLevel()
+{
+	return gameReadLevel(&defaultGame);
+}
+
+bool writeLevel(unsigned int newLevel)
+{
+	return gameWriteLevel(&defaultGame, newLevel);
+}
+
+void holdLevelFile(bool hold)
+{
+	gameHoldLevelFile(&defaultGame, hold);
+}
+
+bool openPack(const char* fileName)
+{
+	return gameOpenPack(&defaultGame, fileName);
+}
+
+void closePack()
+{
+	gameClosePack(&defaultGame);
+}
+
+void twoDdisplay()
+{
+	gameTwoDdisplay(&defaultGame);
+}
+
+bool saveSnapshot(const char* fileName, unsigned int elapsed)
+{
+	return gameSaveSnapshot(&defaultGame, fileName, elapsed);
+}
+
+bool loadSnapshot(const char* fileName, unsigned int* elapsed)
+{
+	return gameLoadSnapshot(&defaultGame, fileName, elapsed);
+}
+
+void clearSnapshot(const char* fileName)
+{
+	gameClearSnapshot(&defaultGame, fileName);
+}
+
+// Allocate a maze for making mazes separately from the game.
+struct maze* newMaze()
+{
+	return calloc(1, sizeof(struct maze));
+}
+
+// Free a maze from newMaze, including its arena.
+void freeMaze(struct maze* m)
+{
+	if (m == NULL) { return; }
+	free(m->arena);
+	free(m);
+}
+
+// Make a normal maze for a level from a seed, without changing anything in the game. The exit path set for the default
+// game is used.
+void makeMaze(struct maze* m, unsigned int lvl, unsigned int seed, mazegen_t gen)
+{
+	if (lvl < 1) { lvl = 1; }
+	if (gen >= GENCOUNT) { gen = (lvl - 1) % GENCOUNT; }
+
+	m->level = lvl;
+	m->seed = seed;
+	m->mode = MODENORMAL;
+	m->gen = gen;
+	m->exitPath = defaultGame.exitPath;
+	buildMaze(m);
+}
+
+// Return the cells along each side of a maze.
+unsigned int getMazeSize(struct maze* m)
+{
+	return m->Msize;
+}
+
+// Get where the player starts in a maze, the same place as in the game.
+void getMazeStart(struct maze* m, unsigned int* x, unsigned int* y)
+{
+	(void)m;							// Every maze made with makeMaze starts in the same place.
+	*x = MAZEBORDER + (BLKSIZE / 2);
+	*y = MAZEBORDER + (BLKSIZE / 2);
+}
+
+// Return the difficulty wanted for a level, the path to the exit over the width of the maze, that the candidates for
+// each maze are picked to be nearest to.
+float getMazeTarget(unsigned int level)
+{
+	return difficultyTarget((level < 1) ? 1 : level);
+}
+
+// Get the measures of a maze.
+void getMazeStats(struct maze* m, struct mazestats* stats)
+{
+	*stats = m->stats;
+}
+
+// Return the most memory a maze used while it was made, the maze array plus the most working memory used after it.
+size_t getMazeBytes(struct maze* m)
+{
+	return m->arenaPeak;
+}
+
+// Return the most working memory the generator used while making a maze, on top of the maze array.
+size_t getGeneratorBytes(struct maze* m)
+{
+	return m->genBytes;
+}
+
+// Return a cell in a maze, anything outside of the maze is a block.
+char getMazeCell(struct maze* m, unsigned int x, unsigned int y)
+{
+	if ((m->ready == false) || (x >= m->Msize) || (y >= m->Mrows)) { return '#'; }
+	return getCell(m, x, y);
+}
+
+// Get the bits of a maze for the Bitboard kernels. The exit is a space in the grid, it is only told apart by its position.
+void getMazeGrid(struct maze* m, struct bitgrid* g)
+{
+	g->cells = m->cells;
+	g->cols = m->Msize;
+	g->rows = (m->ready == true) ? m->Mrows : 0;
+	g->rowBytes = m->rowBytes;
+}
@@ -1,27 +1,183 @@
-#pragma once
-
-// Maze APIs to support graphical display and game operation.
-
-#include <stdbool.h>					// for booleans.
-
-#define MAXLEVEL   25					// Highest possible game level.
-
-// Access functions for the maze generation and play to support the Labyrinth game.
-
-void generateMaze(void);				// Create a new maze.
-
-unsigned int movePlayer(char move);		// Move player, return if move was successful and if level complete.
-										// 0 move not possible, 1 moved OK, 2 end of level (found the exit).
-
-char get2DView(int x, int y);			// Accessor to get the view around the player. Out of range requests are reported as blocks.
-char get3DView(int f, int s);			// Accessor to get view along a corridor to support 3D display. Out of range requests are reported as blocks.
-
-unsigned int getLevel(void);			// Return the current game level.
-
-unsigned int readLevel(void);			// Read the game level from the data file.
-										// This is only needed right at the start of the game to show the current level.
-
-bool writeLevel(unsigned int newLevel);	// Write the newLevel to the data file, return false if this fails. 
-										// Can be called to set the level back to 1 to go back to easy mode.
-
-void twoDdisplay(void);					// Display the entire maze (only used during PC development).
+#pragma once
+
+// Maze APIs to support graphical display and game operation.
+
+#include <stdbool.h>					// for booleans.
+#include <stddef.h>						// For sizes.
+
+#include "Bitboard.h"					// For the bit grid the tools can get.
+
+#define MAXLEVEL   25					// Highest possible game level.
+
+// A value from enum MAZEGEN.
+typedef unsigned int mazegen_t;
+
+// Methods that mazes can be generated with.
+enum MAZEGEN
+{
+	GENBLOCKS    = 0,					// Random building block tiles, the original maze style.
+	GENBACKTRACK = 1,					// Recursive backtracker, long winding corridors.
+	GENKRUSKAL   = 2,					// Kruskal's algorithm, lots of short dead ends.
+	GENWILSON    = 3,					// Wilson's algorithm, no bias to any maze style.
+	GENPRIM      = 4,					// Prim's algorithm, many short branches.
+	GENCOUNT     = 5,					// Number of generators.
+	GENBYLEVEL   = 5,					// Take turns through the generators as the level goes up.
+};
+
+// A value from enum MAZEMODE.
+typedef unsigned int mazemode_t;
+
+// Shapes of maze that can be played.
+enum MAZEMODE
+{
+	MODENORMAL   = 0,					// Square maze that gets bigger with each level.
+	MODECORRIDOR = 1,					// Long corridor, the maze carries on south with the exit a long way down.
+	MODEWORLD    = 2,					// Open world, the maze carries on in every direction.
+	MODECOUNT    = 3,					// Number of maze shapes.
+};
+
+#define MAXCANDIDATES 8					// Most candidate mazes made to pick each maze from.
+
+// Measures of how hard a maze is, worked out when it is made.
+struct mazestats
+{
+	unsigned int path;					// Moves from the start to the exit.
+	unsigned int spaces;				// Spaces that can be reached from the start.
+	unsigned int deadEnds;				// Spaces with only one way out.
+	unsigned int junctions;				// Spaces with three or more ways out.
+	float corridor;						// Average moves along a corridor between junctions and dead ends.
+	float branching;					// Average ways on from a junction.
+	unsigned int repairs;				// Walls opened to join parts of the maze that couldn't be reached.
+};
+
+// Access functions for the maze generation and play to support the Labyrinth game.
+
+void generateMaze(void);				// Create a new maze.
+void stopMaze(void);					// Wait for any maze being made and the files queued to be saved in the
+										// background, call before exiting.
+
+void setGenerator(mazegen_t gen);		// Select the generator used for the next maze, a value from enum MAZEGEN.
+mazegen_t getGenerator(void);			// Return the generator selected.
+mazegen_t getNextGenerator(void);		// Return the generator the maze for the level will be made with, GENCOUNT from a pack.
+const char* getGeneratorName(mazegen_t gen);	// Return the name of a generator to show the player.
+
+unsigned int movePlayer(char move);		// Move player, return if move was successful and if level complete.
+										// 0 move not possible, 1 moved OK, 2 end of level (found the exit).
+unsigned int getDistanceToExit(void);	// Return the moves from the player to the exit, 0 if not known.
+unsigned int getHintDirection(void);	// Return the direction 1-4 (as the player faces) to move towards the exit, 0 if not known.
+char getSolveMove(void);				// Return the move ('f', 'l' or 'r') for movePlayer towards the exit, 0 if not known.
+void getPlayerPosition(unsigned int* x, unsigned int* y, unsigned int* d);	// Get the player's cell and the way they face
+										// (1=North 2=East 3=South 4=West), any pointer can be NULL.
+
+char get2DView(int x, int y);			// Accessor to get the view around the player. Out of range requests are reported as blocks.
+char get3DView(int f, int s);			// Accessor to get view along a corridor to support 3D display. Out of range requests are reported as blocks.
+
+unsigned int getLevel(void);			// Return the current game level.
+unsigned int getPlayedLevel(void);		// Return the level of the maze being played, still the same once it is completed.
+unsigned int getPlayedSeed(void);		// Return the seed the maze being played was made from.
+mazegen_t getPlayedGenerator(void);		// Return the generator the maze being played was made with, GENCOUNT for a pack maze.
+mazemode_t getPlayedMode(void);			// Return the shape of the maze being played.
+
+void setEndless(bool on);				// Turn endless mode on or off. In endless mode levels carry on past MAXLEVEL.
+bool getEndless(void);					// Return true if in endless mode.
+
+void setSeed(unsigned int seed);		// Set the seed the next maze is made from. The same seed always gives the same maze.
+unsigned int getSeed(void);				// Return the seed the next maze will be made from, to show as a code to share.
+
+void setExitPath(unsigned int moves);	// Set the moves wanted from the start to the exit of the next maze, 0 for as far as possible.
+unsigned int getExitPath(void);			// Return the moves wanted from the start to the exit.
+
+void setCandidates(unsigned int count);	// Set how many candidate mazes each maze is picked from, 1 to MAXCANDIDATES.
+										// They are made at the same time and the one nearest the level's difficulty is kept.
+unsigned int getCandidates(void);		// Return how many candidate mazes each maze is picked from.
+void getStats(struct mazestats* stats);	// Get the measures of the maze being played (all 0 if it wasn't measured).
+
+void setMode(mazemode_t mode);			// Select the shape of maze played for the next maze, a value from enum MAZEMODE.
+mazemode_t getMode(void);				// Return the shape of maze selected.
+const char* getModeName(mazemode_t mode);	// Return the name of a maze shape to show the player.
+
+unsigned int readLevel(void);			// Read the game level from the data file, only the first call reads the file.
+										// This is only needed right at the start of the game to show the current level.
+
+bool writeLevel(unsigned int newLevel);	// Set the level and write it to the data file in the background, return false if
+										// this fails. Can be called to set the level back to 1 to go back to easy mode.
+void holdLevelFile(bool hold);			// Hold the level file so levels set are only kept in memory, or let it go again.
+
+bool openPack(const char* fileName);	// Open a .lab pack of mazes, levels in it are then played from the pack rather than generated.
+										// NULL opens levels.lab next to the level file. Return false if there is no valid pack.
+void closePack(void);					// Stop using the pack, levels are generated again.
+
+void twoDdisplay(void);					// Display the entire maze (only used during PC development).
+
+bool saveSnapshot(const char* fileName, unsigned int elapsed);	// Save the level being played to carry on later, with
+										// elapsed kept for the caller. NULL saves resume.bin next to the level file.
+bool loadSnapshot(const char* fileName, unsigned int* elapsed);	// Carry on the level in a snapshot without making the
+										// maze again, return false if there isn't one for the level saved.
+void clearSnapshot(const char* fileName);	// Remove the snapshot, when there is no level to carry on.
+
+// Games of their own, each with its own mazes, player, level and settings, so more than one game can be played at once,
+// even on different threads. The functions above play the default game, the one the Wii U game uses. Each of them has a
+// version below that plays the game given instead. Only the default game keeps its level in the level file, others
+// keep it in memory.
+struct game;
+
+struct game* newGame(void);				// Allocate a game with the default settings, NULL if there is no memory.
+void freeGame(struct game* g);			// Free a game from newGame, waiting for any maze it is making.
+
+void gameGenerateMaze(struct game* g);
+void gameStopMaze(struct game* g);
+void gameSetGenerator(struct game* g, mazegen_t gen);
+mazegen_t gameGetGenerator(struct game* g);
+mazegen_t gameGetNextGenerator(struct game* g);
+unsigned int gameMovePlayer(struct game* g, char move);
+unsigned int gameGetDistanceToExit(struct game* g);
+unsigned int gameGetHintDirection(struct game* g);
+char gameGetSolveMove(struct game* g);
+void gameGetPlayerPosition(struct game* g, unsigned int* x, unsigned int* y, unsigned int* d);
+char gameGet2DView(struct game* g, int x, int y);
+char gameGet3DView(struct game* g, int f, int s);
+unsigned int gameGetLevel(struct game* g);
+unsigned int gameGetPlayedLevel(struct game* g);
+unsigned int gameGetPlayedSeed(struct game* g);
+mazegen_t gameGetPlayedGenerator(struct game* g);
+mazemode_t gameGetPlayedMode(struct game* g);
+void gameSetEndless(struct game* g, bool on);
+bool gameGetEndless(struct game* g);
+void gameSetSeed(struct game* g, unsigned int seed);
+unsigned int gameGetSeed(struct game* g);
+void gameSetExitPath(struct game* g, unsigned int moves);
+unsigned int gameGetExitPath(struct game* g);
+void gameSetCandidates(struct game* g, unsigned int count);
+unsigned int gameGetCandidates(struct game* g);
+void gameGetStats(struct game* g, struct mazestats* stats);
+void gameSetMode(struct game* g, mazemode_t mode);
+mazemode_t gameGetMode(struct game* g);
+unsigned int gameReadLevel(struct game* g);
+bool gameWriteLevel(struct game* g, unsigned int newLevel);
+void gameHoldLevelFile(struct game* g, bool hold);
+bool gameOpenPack(struct game* g, const char* fileName);
+void gameClosePack(struct game* g);
+void gameTwoDdisplay(struct game* g);
+bool gameSaveSnapshot(struct game* g, const char* fileName, unsigned int elapsed);
+bool gameLoadSnapshot(struct game* g, const char* fileName, unsigned int* elapsed);
+void gameClearSnapshot(struct game* g, const char* fileName);
+
+// Mazes made separately from the game, for tools that make and check mazes on a PC. Each maze has its own memory, so
+// different mazes can be made on different threads at the same time. Only normal (square) mazes are made this way.
+struct maze;
+
+struct maze* newMaze(void);				// Allocate a maze to make mazes in, NULL if there is no memory.
+void freeMaze(struct maze* m);			// Free a maze from newMaze.
+void makeMaze(struct maze* m, unsigned int level, unsigned int seed, mazegen_t gen);	// Make the maze for a level from a seed,
+										// with a generator from enum MAZEGEN. The same as the game makes from that seed,
+										// with the exit path set for the default game.
+unsigned int getMazeSize(struct maze* m);	// Return the cells along each side of the maze.
+void getMazeStart(struct maze* m, unsigned int* x, unsigned int* y);	// Get where the player starts.
+char getMazeCell(struct maze* m, unsigned int x, unsigned int y);	// Return '#', ' ' or 'E' for a cell, out of range is '#'.
+void getMazeGrid(struct maze* m, struct bitgrid* g);				// Get the maze as bits, for the Bitboard kernels.
+void getMazeStats(struct maze* m, struct mazestats* stats);	// Get the measures of a maze.
+float getMazeTarget(unsigned int level);	// Return the difficulty, path moves over maze width, candidates are picked by.
+size_t getMazeBytes(struct maze* m);	// Return the most memory used while making a maze, the maze array and working memory.
+size_t getGeneratorBytes(struct maze* m);	// Return the most working memory the generator used, on top of the maze array.
+bool savePack(const char* fileName, struct maze* mazes[], unsigned int count);	// Write mazes to a .lab pack for openPack,
+										// return false if this fails.
@@ -0,0 +1,283 @@
+// Recording the moves made in a game, and playing them back. A seed makes exactly the same maze on the Wii U and on a PC,
+// so the settings the first maze was made with plus the moves passed to movePlayer are enough to play a whole game again.
+// Moves are only counted on the frames that read input, so a replay keeps in step however long each frame takes.
+// Each move is 2 bits for forward, left or right, with the frames since the last move above them, written as a varint
+// of 7 bits to a byte. A move every few frames takes one byte, so a level is a few hundred bytes at most.
+
+#include <stdint.h>						// For exact sized integers.
+#include <string.h>						// For memcmp.
+
+#include "Replay.h"						// For the replay functions.
+#include "Labyrinth.h"					// For the settings mazes are made with.
+#include "Storage.h"					// For the replay file.
+
+#define REPLAYMAGIC   "LRPL"			// Start of a replay file.
+#define REPLAYVERSION 1					// Version of the replay file layout.
+#define REPLAYHEAD    48				// Bytes in the file header, before the moves.
+#define REPLAYFILE    "replay.lrp"		// Replay file used when none is set, in the game's directory.
+
+// Settings the first maze of a game is made with, every maze after it follows from them.
+struct settings
+{
+	uint32_t seed;						// Seed of the first maze.
+	uint32_t level;						// Level of the first maze.
+	uint32_t gen;						// Generator, a value from enum MAZEGEN.
+	uint32_t mode;						// Maze shape, a value from enum MAZEMODE.
+	uint32_t candidates;				// Candidate mazes each maze is picked from.
+	uint32_t exitPath;					// Moves wanted from the start to the exit.
+	bool endless;						// Set for endless mode.
+};
+
+static char replayName[STORAGEPATH] = REPLAYFILE;	// File recordings go to and replays come from.
+static unsigned char replayData[REPLAYHEAD + REPLAYBYTES];	// Replay file as written, the header then the moves.
+static unsigned char* const moves = replayData + REPLAYHEAD;	// Moves recorded or being replayed.
+static size_t movesUsed = 0;			// Bytes of moves.
+static size_t replayPos = 0;			// Next byte of moves to be replayed.
+static struct settings recorded;		// Settings the recording was started with.
+static struct settings saved;			// Player's own settings, put back after a replay.
+static uint32_t moveCount = 0;			// Moves recorded.
+static uint32_t levels = 0;				// Levels completed in the recording.
+static unsigned int idle = 0;			// Frames since the last move when recording, or left until the next move in a replay.
+static char nextMove = 0;				// Next move in the replay, 0 once there are no more.
+static bool recording = false;			// Set while moves are being recorded.
+static bool replaying = false;			// Set while a replay is being played.
+
+// Get a 32-bit number stored least significant byte first, so files are the same on the Wii U and a PC.
+static uint32_t get32(const unsigned char* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Put a 32-bit number in a file header, least significant byte first.
+static void put32(unsigned char* p, uint32_t v)
+{
+	p[0] = (unsigned char)v;
+	p[1] = (unsigned char)(v >> 8);
+	p[2] = (unsigned char)(v >> 16);
+	p[3] = (unsigned char)(v >> 24);
+}
+
+// Get the settings the next maze will be made with.
+static void getSettings(struct settings* s)
+{
+	s->seed = getSeed();
+	s->level = readLevel();
+	s->gen = getGenerator();
+	s->mode = getMode();
+	s->candidates = getCandidates();
+	s->exitPath = getExitPath();
+	s->endless = getEndless();
+}
+
+// Make the next maze with the settings given. Endless mode goes first, as it changes the levels allowed.
+static void putSettings(const struct settings* s)
+{
+	setEndless(s->endless);
+	writeLevel(s->level);
+	setSeed(s->seed);
+	setGenerator(s->gen);
+	setMode(s->mode);
+	setCandidates(s->candidates);
+	setExitPath(s->exitPath);
+}
+
+// Queue the recording to be written to the replay file by the saver thread. The header goes in front of the moves, so
+// the whole file is copied in one go. Return false if this fails.
+static bool writeRecording(void)
+{
+	unsigned char* head = replayData;	// Header for the file.
+
+	memset(head, 0, REPLAYHEAD);
+	memcpy(head, REPLAYMAGIC, 4);
+	put32(head + 4, REPLAYVERSION);
+	put32(head + 8, recorded.seed);
+	put32(head + 12, recorded.level);
+	put32(head + 16, recorded.gen);
+	put32(head + 20, recorded.mode);
+	put32(head + 24, recorded.candidates);
+	put32(head + 28, recorded.exitPath);
+	put32(head + 32, (recorded.endless == true) ? 1 : 0);
+	put32(head + 36, moveCount);
+	put32(head + 40, levels);
+	put32(head + 44, (uint32_t)movesUsed);
+
+	return storageQueue(replayName, replayData, REPLAYHEAD + movesUsed, false);
+}
+
+// Get the next move of the replay and the frames before it, or set nextMove to 0 if there are no more.
+static void readNextMove(void)
+{
+	uint64_t v = 0;			// Move and frames before it.
+	unsigned int shift = 0;	// Place of the next 7 bits.
+	unsigned char b;		// Byte of the varint.
+
+	nextMove = 0;
+	do
+	{
+		if ((replayPos >= movesUsed) || (shift > 56)) { return; }
+		b = moves[replayPos++];
+		v |= (uint64_t)(b & 0x7F) << shift;
+		shift += 7;
+	} while ((b & 0x80) != 0);
+
+	if ((v & 3) == 3) { return; }
+	nextMove = "flr"[v & 3];
+	idle = ((v >> 2) > UINT32_MAX) ? UINT32_MAX : (unsigned int)(v >> 2);
+}
+
+// Set the file recordings go to and replays come from. With NULL the game's replay.lrp is used, next to the level file.
+void setReplayFile(const char* fileName)
+{
+	if (fileName == NULL) { fileName = REPLAYFILE; }
+	strncpy(replayName, fileName, sizeof(replayName) - 1);
+	replayName[sizeof(replayName) - 1] = '\0';
+}
+
+// Start a new recording, call just before the first maze is made. Replays aren't recorded again.
+void startRecording()
+{
+	if (replaying == true) { return; }
+	getSettings(&recorded);
+	movesUsed = 0;
+	moveCount = 0;
+	levels = 0;
+	idle = 0;
+	recording = true;
+}
+
+// Record the move passed to movePlayer, called on every frame that reads input so the frames between moves are known.
+// When movePlayer returns 2 a level is complete, and the recording is written out so it isn't lost if the game is
+// switched off. If the recording fills up it is written out and stopped, keeping the moves so far.
+void recordMove(char move, unsigned int result)
+{
+	uint64_t v;				// Move and frames before it.
+	uint64_t code;			// Move as 2 bits.
+
+	if (recording == false) { return; }
+
+	if ((move == 'f') || (move == 'F')) { code = 0; }
+	else if ((move == 'l') || (move == 'L')) { code = 1; }
+	else if ((move == 'r') || (move == 'R')) { code = 2; }
+	else { code = 3; }
+
+	if (code == 3) { idle++; }
+	else
+	{
+		if ((movesUsed + 10) > REPLAYBYTES)
+		{
+			stopRecording();
+			return;
+		}
+		v = ((uint64_t)idle << 2) | code;
+		while (v >= 0x80)
+		{
+			moves[movesUsed++] = (unsigned char)(v | 0x80);
+			v >>= 7;
+		}
+		moves[movesUsed++] = (unsigned char)v;
+		moveCount++;
+		idle = 0;
+	}
+
+	if (result == 2)
+	{
+		levels++;
+		writeRecording();
+	}
+}
+
+// Write out the recording and stop recording. Return false if writing it failed.
+bool stopRecording()
+{
+	if (recording == false) { return true; }
+	recording = false;
+	return writeRecording();
+}
+
+// Load the replay and make the next maze with the settings it was recorded with, keeping the player's own settings to
+// put back after. Any recording is stopped first. Return false if there isn't a valid replay.
+bool startReplay()
+{
+	unsigned char head[REPLAYHEAD];		// Header of the file.
+	struct storefile* inFile;
+	uint32_t bytes;						// Bytes of moves in the file.
+
+	stopRecording();
+	stopReplay();
+	inFile = storageOpen(replayName, false);
+	if (inFile == NULL) { return false; }
+
+	if ((storageRead(inFile, head, REPLAYHEAD) != REPLAYHEAD) || (memcmp(head, REPLAYMAGIC, 4) != 0) ||
+		(get32(head + 4) != REPLAYVERSION) || (get32(head + 16) > GENBYLEVEL) || (get32(head + 20) >= MODECOUNT) ||
+		(get32(head + 44) > REPLAYBYTES))
+	{
+		storageClose(inFile);
+		return false;
+	}
+	bytes = get32(head + 44);
+	if (storageRead(inFile, moves, bytes) != bytes)
+	{
+		storageClose(inFile);
+		movesUsed = 0;
+		return false;
+	}
+	storageClose(inFile);
+
+	recorded.seed = get32(head + 8);
+	recorded.level = get32(head + 12);
+	recorded.gen = get32(head + 16);
+	recorded.mode = get32(head + 20);
+	recorded.candidates = get32(head + 24);
+	recorded.exitPath = get32(head + 28);
+	recorded.endless = (get32(head + 32) & 1) != 0;
+	moveCount = get32(head + 36);
+	levels = get32(head + 40);
+	movesUsed = bytes;
+
+	// The replay's levels are only set in memory, so the player's level file is never changed by a replay, even if the
+	// game stops part way through it.
+	getSettings(&saved);
+	holdLevelFile(true);
+	putSettings(&recorded);
+	replayPos = 0;
+	readNextMove();
+	replaying = true;
+	return true;
+}
+
+// Get the move to pass to movePlayer for this frame, called on every frame that reads input the same as recordMove.
+// The move is 0 on the frames between moves. Return false once every move has been played.
+bool getReplayMove(char* move)
+{
+	*move = 0;
+	if ((replaying == false) || (nextMove == 0)) { return false; }
+	if (idle > 0)
+	{
+		idle--;
+		return true;
+	}
+	*move = nextMove;
+	readNextMove();
+	return true;
+}
+
+// Stop the replay, putting back the player's own settings and level.
+void stopReplay()
+{
+	if (replaying == false) { return; }
+	replaying = false;
+	putSettings(&saved);
+	holdLevelFile(false);
+}
+
+// Return true while a replay is being played.
+bool isReplaying()
+{
+	return replaying;
+}
+
+// Return the levels completed when the replay being played was recorded.
+unsigned int getReplayLevels()
+{
+	return levels;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Recording the moves of a game to a small file, and playing them back through the game the same way on the Wii U and a PC.
+
+#include <stdbool.h>					// For booleans.
+
+#define REPLAYBYTES 65536				// Most bytes of moves kept in a recording.
+
+void setReplayFile(const char* fileName);	// Set the file recordings go to and replays come from, NULL for replay.lrp by the level file.
+
+void startRecording(void);				// Start a new recording from the settings the next maze will be made with.
+void recordMove(char move, unsigned int result);	// Record the move passed to movePlayer on a frame that reads input (0 for
+										// no move), and its result. The recording is written out when a level is completed.
+bool stopRecording(void);				// Write out the recording and stop, return false if writing it failed.
+
+bool startReplay(void);					// Load the replay and play with its settings, return false if there isn't a valid replay.
+bool getReplayMove(char* move);			// Get the move for this frame (0 for no move), return false once the replay is over.
+void stopReplay(void);					// Stop the replay and put back the settings from before it.
+bool isReplaying(void);					// Return true while a replay is being played.
+unsigned int getReplayLevels(void);		// Return the levels completed when the replay was recorded.
@@ -0,0 +1,306 @@
+// The log of levels completed. Each level completed adds a record (RUNRECORD bytes: "LRUN", version, the fields of
+// struct runrecord in order, then a check of the bytes before it) to the end of runs.log. Numbers are 32-bit, least
+// significant byte first, the same as the game's other files. Records are only ever added to the end, so records
+// already written are never at risk. If the game stops part way through adding one, the part record is skipped when
+// the log is read, by looking for the next bytes that start with "LRUN" and pass the check.
+//
+// The index, runs.idx, is a header (INDEXHEAD bytes: "LRNX", version, records in the log, levels kept, the bytes in the
+// log and the kinds of maze kept) then the best time for each level of each kind of maze, normal mazes then endless
+// ones. A kind of maze is a normal maze from each generator, a normal maze from a pack, or one of the other shapes, so a
+// time is only ever compared with times for the same kind of maze. It is read in one go at the start, so the best time
+// for a level is just a look up. It is written again each time a level is completed, and made again from the log if it is missing, damaged,
+// or was written for a log of a different size, such as when the game stopped between writing the log and the index.
+//
+// Both are queued for the saver thread, so completing a level never waits for the SD card.
+//
+// Frame times are counted in buckets rather than kept, so working out the percentiles for a level takes the same
+// memory however long the level is played for.
+
+#include <string.h>						// For memcmp and memset.
+
+#include "RunLog.h"						// For the run log functions.
+#include "Labyrinth.h"					// For the generators and shapes of maze.
+#include "Storage.h"					// For the log and index files.
+
+#define RUNMAGIC     "LRUN"				// Start of every record.
+#define RUNVERSION   1					// Version of the record layout.
+#define RUNRECORD    64					// Bytes of each record.
+#define RUNFILE      "runs.log"			// Log file, in the game's directory.
+#define INDEXMAGIC   "LRNX"				// Start of the index.
+#define INDEXVERSION 3					// Version of the index layout.
+#define INDEXHEAD    24					// Bytes of the index header.
+#define INDEXFILE    "runs.idx"			// Index file, in the game's directory.
+#define RUNSHAPES    (GENCOUNT + MODECOUNT)	// Kinds of maze with their own best times, a normal maze from each generator,
+										// a normal maze from a pack, then the other shapes.
+#define RUNBEST      (2 * RUNSHAPES * RUNLEVELS)	// Best times kept, for each kind of maze with endless mode off and on.
+#define INDEXBYTES   (INDEXHEAD + (RUNBEST * 4))	// Bytes of the index.
+
+static uint32_t best[RUNBEST];			// Best time for each level in milliseconds (0 if none), level 1 first.
+static unsigned char indexData[INDEXBYTES];	// Contents of the index, read or written in one go.
+static uint32_t runCount = 0;			// Records in the log.
+static uint32_t logBytes = 0;			// Bytes in the log, including any part records.
+static struct runrecord lastRun;		// Last level added to the log since the start.
+static bool lastLogged = false;			// Set once a level has been added to the log since the start.
+static uint32_t buckets[RUNBUCKETS];	// Frames of the level being played in each bucket of frame times.
+static uint32_t frames = 0;				// Frames of the level being played.
+static uint32_t frameMax = 0;			// Longest frame of the level being played, in microseconds.
+
+// Get a 32-bit number stored least significant byte first, so files are the same on the Wii U and a PC.
+static uint32_t get32(const unsigned char* p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Put a 32-bit number in a file, least significant byte first.
+static void put32(unsigned char* p, uint32_t v)
+{
+	p[0] = (unsigned char)v;
+	p[1] = (unsigned char)(v >> 8);
+	p[2] = (unsigned char)(v >> 16);
+	p[3] = (unsigned char)(v >> 24);
+}
+
+// Work out the check of a record, an FNV-1a hash of the bytes before it, so a part record isn't taken for a record.
+static uint32_t checkRecord(const unsigned char* p)
+{
+	uint32_t h = 2166136261u;			// Hash so far.
+
+	for (unsigned int i = 0; i < RUNRECORD - 4; i++) { h = (h ^ p[i]) * 16777619u; }
+	return h;
+}
+
+// Put a record in the bytes it is kept as in the log.
+static void packRecord(unsigned char* p, const struct runrecord* r)
+{
+	memset(p, 0, RUNRECORD);
+	memcpy(p, RUNMAGIC, 4);
+	put32(p + 4, RUNVERSION);
+	put32(p + 8, r->seed);
+	put32(p + 12, r->level);
+	put32(p + 16, r->mode);
+	put32(p + 20, r->gen);
+	put32(p + 24, r->flags);
+	put32(p + 28, r->moves);
+	put32(p + 32, r->turns);
+	put32(p + 36, r->elapsed);
+	put32(p + 40, r->frames);
+	put32(p + 44, r->frameP50);
+	put32(p + 48, r->frameP90);
+	put32(p + 52, r->frameP99);
+	put32(p + 56, r->frameMax);
+	put32(p + 60, checkRecord(p));
+}
+
+// Get a record from the bytes kept in the log, return false if they aren't the start of a record.
+static bool unpackRecord(const unsigned char* p, struct runrecord* r)
+{
+	if ((memcmp(p, RUNMAGIC, 4) != 0) || (get32(p + 4) != RUNVERSION) || (get32(p + 60) != checkRecord(p)))
+	{
+		return false;
+	}
+	r->seed = get32(p + 8);
+	r->level = get32(p + 12);
+	r->mode = get32(p + 16);
+	r->gen = get32(p + 20);
+	r->flags = get32(p + 24);
+	r->moves = get32(p + 28);
+	r->turns = get32(p + 32);
+	r->elapsed = get32(p + 36);
+	r->frames = get32(p + 40);
+	r->frameP50 = get32(p + 44);
+	r->frameP90 = get32(p + 48);
+	r->frameP99 = get32(p + 52);
+	r->frameMax = get32(p + 56);
+	return true;
+}
+
+// Get where the best time is kept for a level of a kind of maze, or RUNBEST if it isn't kept. Only normal mazes use
+// the generator, GENCOUNT is a normal maze from a pack.
+static unsigned int bestSlot(uint32_t mode, uint32_t gen, bool endless, uint32_t level)
+{
+	unsigned int shape;					// Kind of maze.
+
+	if ((mode >= MODECOUNT) || ((mode == MODENORMAL) && (gen > GENCOUNT)) || (level < 1) || (level > RUNLEVELS))
+	{
+		return RUNBEST;
+	}
+	shape = (mode == MODENORMAL) ? gen : GENCOUNT + mode;
+	return (((endless == true) ? RUNSHAPES : 0) + shape) * RUNLEVELS + (level - 1);
+}
+
+// Keep the time for a level if it is the best so far for its kind of maze. Levels partly played by auto-solve don't count.
+static void addBest(const struct runrecord* r)
+{
+	uint32_t time = (r->elapsed > 0) ? r->elapsed : 1;	// Time taken, 0 is kept for no time.
+	unsigned int i = bestSlot(r->mode, r->gen, (r->flags & RUNENDLESS) != 0, r->level);	// Where the time is kept.
+
+	if (((r->flags & RUNAUTOSOLVE) != 0) || (i == RUNBEST)) { return; }
+	if ((best[i] == 0) || (time < best[i])) { best[i] = time; }
+}
+
+// Queue the index to be written in place of the old one, return false if this fails.
+static bool writeIndex(void)
+{
+	unsigned char* data = indexData;	// Contents of the index.
+
+	memset(data, 0, INDEXHEAD);
+	memcpy(data, INDEXMAGIC, 4);
+	put32(data + 4, INDEXVERSION);
+	put32(data + 8, runCount);
+	put32(data + 12, RUNLEVELS);
+	put32(data + 16, logBytes);
+	put32(data + 20, RUNSHAPES);
+	for (unsigned int i = 0; i < RUNBEST; i++) { put32(data + INDEXHEAD + (i * 4), best[i]); }
+
+	return storageQueue(INDEXFILE, data, INDEXBYTES, false);
+}
+
+// Read the index, return false if it isn't there or isn't valid.
+static bool readIndex(void)
+{
+	unsigned char* data = indexData;	// Contents of the index.
+	struct storefile* inFile;
+	size_t bytes;						// Bytes read.
+
+	inFile = storageOpen(INDEXFILE, false);
+	if (inFile == NULL) { return false; }
+	bytes = storageRead(inFile, data, INDEXBYTES);
+	storageClose(inFile);
+	if ((bytes != INDEXBYTES) || (memcmp(data, INDEXMAGIC, 4) != 0) || (get32(data + 4) != INDEXVERSION) ||
+		(get32(data + 12) != RUNLEVELS) || (get32(data + 20) != RUNSHAPES))
+	{
+		return false;
+	}
+
+	runCount = get32(data + 8);
+	logBytes = get32(data + 16);
+	for (unsigned int i = 0; i < RUNBEST; i++) { best[i] = get32(data + INDEXHEAD + (i * 4)); }
+	return true;
+}
+
+// Add a record from the log to the best times, when making the index again.
+static void indexRecord(const struct runrecord* r, void* arg)
+{
+	(void)arg;
+	addBest(r);
+}
+
+// Load the index of best times, or make it again from the log if it is missing, damaged or doesn't match the log.
+void startRunLog()
+{
+	if ((readIndex() == true) && (logBytes == storageSize(RUNFILE))) { return; }
+
+	memset(best, 0, sizeof(best));
+	runCount = readRunLog(indexRecord, NULL);
+	logBytes = (uint32_t)storageSize(RUNFILE);
+	if (runCount > 0) { writeIndex(); }
+	else { storageRemove(INDEXFILE); }
+}
+
+// Add the time a frame took to run to the level being played.
+void logFrame(unsigned int us)
+{
+	unsigned int b = us / RUNBUCKETUS;	// Bucket the frame goes in.
+
+	if (b >= RUNBUCKETS) { b = RUNBUCKETS - 1; }
+	buckets[b]++;
+	frames++;
+	if (us > frameMax) { frameMax = us; }
+}
+
+// Forget the frame times, as a level starts.
+void logLevelStart()
+{
+	memset(buckets, 0, sizeof(buckets));
+	frames = 0;
+	frameMax = 0;
+}
+
+// Get the time percent of the frames ran in, the top of the bucket the frame is in, in microseconds.
+static uint32_t framePercentile(unsigned int percent)
+{
+	uint64_t wanted = (((uint64_t)frames * percent) + 99) / 100;	// Frames that ran in the time.
+	uint64_t seen = 0;												// Frames in the buckets so far.
+
+	if (frames == 0) { return 0; }
+	for (unsigned int i = 0; i < RUNBUCKETS - 1; i++)
+	{
+		seen += buckets[i];
+		if (seen >= wanted) { return ((i + 1) * RUNBUCKETUS < frameMax) ? (i + 1) * RUNBUCKETUS : frameMax; }
+	}
+	return frameMax;
+}
+
+// Fill in the frame times of the level just completed, add it to the end of the log, and keep its time if it is the
+// best for the level. Both are queued for the saver thread. Return false if the log or the index couldn't be written.
+bool logLevel(struct runrecord* r)
+{
+	unsigned char data[RUNRECORD];		// Record as kept in the log.
+
+	r->frames = frames;
+	r->frameP50 = framePercentile(50);
+	r->frameP90 = framePercentile(90);
+	r->frameP99 = framePercentile(99);
+	r->frameMax = frameMax;
+	packRecord(data, r);
+	if (storageQueue(RUNFILE, data, RUNRECORD, true) == false) { return false; }
+
+	runCount++;
+	logBytes += RUNRECORD;
+	lastRun = *r;
+	lastLogged = true;
+	addBest(r);
+	return writeIndex();
+}
+
+// Return the best time for a level of a kind of maze in milliseconds, 0 if it hasn't been completed without auto-solve.
+unsigned int getBestTime(unsigned int mode, unsigned int gen, bool endless, unsigned int level)
+{
+	unsigned int i = bestSlot(mode, gen, endless, level);	// Where the time is kept.
+
+	return (i == RUNBEST) ? 0 : best[i];
+}
+
+// Return the last level added to the log since the start, NULL if there hasn't been one.
+const struct runrecord* getLastRun()
+{
+	return (lastLogged == true) ? &lastRun : NULL;
+}
+
+// Return the levels completed in the log.
+unsigned int getRunCount()
+{
+	return runCount;
+}
+
+// Call func for each record in the log, oldest first, and return the records read. Anything that isn't a record, such
+// as part of a record the game stopped while adding, is stepped over a byte at a time to the next record.
+unsigned int readRunLog(void (*func)(const struct runrecord* r, void* arg), void* arg)
+{
+	unsigned char data[RUNRECORD];		// Bytes that may be a record.
+	struct runrecord r;					// Record read.
+	struct storefile* inFile;
+	size_t have;						// Bytes in data.
+	unsigned int count = 0;				// Records read.
+
+	inFile = storageOpen(RUNFILE, false);
+	if (inFile == NULL) { return 0; }
+
+	have = storageRead(inFile, data, RUNRECORD);
+	while (have == RUNRECORD)
+	{
+		if (unpackRecord(data, &r) == true)
+		{
+			func(&r, arg);
+			count++;
+			have = storageRead(inFile, data, RUNRECORD);
+		}
+		else
+		{
+			memmove(data, data + 1, RUNRECORD - 1);
+			have = (RUNRECORD - 1) + storageRead(inFile, data + RUNRECORD - 1, 1);
+		}
+	}
+	storageClose(inFile);
+	return count;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// A log of every level completed, so players can see how they have done and the game's speed can be seen on the Wii U
+// for each size of maze. Each level adds a fixed size record to the end of the log, and an index keeps the best time
+// for each level of each kind of maze so the start screen can show it without reading the log.
+
+#include <stdbool.h>					// For booleans.
+#include <stdint.h>						// For exact sized integers.
+
+#define RUNLEVELS    256				// Levels the index keeps the best time for, endless levels above aren't kept.
+#define RUNBUCKETUS  100				// Microseconds covered by each bucket of frame times.
+#define RUNBUCKETS   512				// Buckets of frame times, the last one holds all the slower frames.
+
+#define RUNAUTOSOLVE 1					// Flag, auto-solve made some of the moves, so the time isn't a best time.
+#define RUNRESUMED   2					// Flag, the level was carried on from a snapshot after the game was closed.
+#define RUNENDLESS   4					// Flag, the level was played in endless mode.
+
+// A level completed, as kept in the log.
+struct runrecord
+{
+	uint32_t seed;						// Seed the maze was made from.
+	uint32_t level;						// Level completed.
+	uint32_t mode;						// Shape of maze played, a value from enum MAZEMODE.
+	uint32_t gen;						// Generator the maze was made with, a value from enum MAZEGEN, GENCOUNT for a pack maze.
+	uint32_t flags;						// RUNAUTOSOLVE, RUNRESUMED and RUNENDLESS.
+	uint32_t moves;						// Moves forward made.
+	uint32_t turns;						// Turns left and right made.
+	uint32_t elapsed;					// Time taken to complete the level, in milliseconds.
+	uint32_t frames;					// Frames the level was played for.
+	uint32_t frameP50;					// Median time to run a frame, in microseconds.
+	uint32_t frameP90;					// Time 90% of frames ran in, in microseconds.
+	uint32_t frameP99;					// Time 99% of frames ran in, in microseconds.
+	uint32_t frameMax;					// Longest time to run a frame, in microseconds.
+};
+
+void startRunLog(void);					// Load the index of best times, call once at the start after storage is started.
+void logFrame(unsigned int us);			// Add the time a frame took to run, in microseconds, to the level being played.
+void logLevelStart(void);				// Forget the frame times, call as each level starts.
+bool logLevel(struct runrecord* r);		// Fill in the frame times of the level just completed, add it to the log and update
+										// the best time. Return false if the log couldn't be written.
+unsigned int getBestTime(unsigned int mode, unsigned int gen, bool endless, unsigned int level);	// Return the best
+										// time in milliseconds for a level of a shape of maze, made with a generator
+										// (GENCOUNT for a pack maze) with endless mode on or off. 0 if there isn't one.
+unsigned int getRunCount(void);			// Return the levels completed in the log.
+const struct runrecord* getLastRun(void);	// Return the last level added to the log since the start, NULL if none.
+unsigned int readRunLog(void (*func)(const struct runrecord* r, void* arg), void* arg);	// Call func for each
+										// record in the log, oldest first. Return the records read.
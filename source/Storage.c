@@ -0,0 +1,630 @@
+// Where the game keeps its files. Each way of keeping files is a backend, a set of functions in the backends table, and
+// the one chosen at the start is used for every file. The game's directory is found once at the start, rather than
+// every time a file is used.
+//
+// Files are never changed in place. Writing goes to a temporary file (the name with .tmp on the end) or to memory, and
+// committing replaces the old file with it, so a file is never left part written whenever the game stops. On a PC
+// rename does this in one go. If the SD card can't rename over a file the old file is removed first, so opening a file
+// reads the temporary file instead if the game stopped in between.
+//
+// Logs are the exception, they are only ever added to, so appending goes straight on the end of the file.
+//
+// Files the game writes while it is being played, such as the level, the replay and the log of levels completed, are
+// queued for the saver thread, so the game never waits for the SD card. The data is copied into the queue, and a file
+// still waiting to be replaced is just given the newer data, so the saver never falls behind. Reading a file, or
+// finding its size, waits for the queue to be written first, so the game always reads back what it last wrote.
+//
+// The memory backend keeps each file as a block of memory. Reading takes a copy, so a file can be replaced while it is
+// being read, and a mutex lets the saver thread write files while the game reads other files.
+
+#include <stdio.h>						// For files.
+#include <stdlib.h>						// For memory.
+#include <string.h>						// For strings.
+#include <stdatomic.h>					// For starting storage once, whichever thread uses it first.
+#include <unistd.h>						// For getcwd.
+
+#include "Storage.h"					// For the storage functions.
+#include "Threads.h"					// For the mutex on files kept in memory.
+
+#define MEMFILES 16						// Most files kept by the memory backend, the game uses a few.
+#define SAVEJOBS 8						// Most writes waiting for the saver thread, the game queues a few at a time.
+#define SAVECORE 0						// Core the saver thread writes files on, it shares with polling the gamepad.
+
+// A file being read or written.
+struct storefile
+{
+	char path[STORAGEPATH];				// Full path to the file.
+	char temp[STORAGEPATH + 4];			// Temporary file written before it replaces the file.
+	bool write;							// Set if the file is being written.
+	bool failed;						// Set if any of a write failed.
+	FILE* file;							// File on the disk.
+	unsigned char* data;				// Memory backend, contents of the file.
+	size_t bytes;						// Bytes in data.
+	size_t size;						// Bytes data has room for.
+	size_t pos;							// Next byte of data to read.
+};
+
+// A file kept by the memory backend, free if it has no path.
+struct memfile
+{
+	char path[STORAGEPATH];				// Full path to the file, the same as it would be on the disk.
+	unsigned char* data;				// Contents of the file.
+	size_t bytes;						// Bytes in the file.
+};
+
+// A write waiting for the saver thread.
+struct savejob
+{
+	char name[STORAGEPATH];				// File written.
+	unsigned char* data;				// Copy of what is written.
+	size_t bytes;						// Bytes in data.
+	bool append;						// Set to add to the end of the file, otherwise the file is replaced.
+};
+
+static char root[STORAGEPATH];			// The game's directory, with a '/' on the end.
+static storage_t storage;				// How files are kept, a value from enum STORAGE.
+static atomic_uint started = 0;			// 0 until storage is started, 1 while starting, 2 once started.
+static struct mutex memLock;			// Lock for the files kept in memory.
+static struct memfile memFiles[MEMFILES];	// Files kept in memory.
+static struct mutex saveLock;			// Lock for the queue of writes.
+static struct event saveWake;			// Set when there is a write queued or the saver should stop.
+static struct event saveDone;			// Set each time the saver finishes a write.
+static struct thread saver;				// Thread writing the queued files.
+static bool saving = false;				// Set from starting the saver thread until it is stopped.
+static bool saveStop = false;			// Set to stop the saver once it has written everything queued.
+static struct savejob jobs[SAVEJOBS];	// Queue of writes, oldest first from saveHead.
+static unsigned int saveHead = 0;		// Oldest write in the queue.
+static unsigned int saveCount = 0;		// Writes in the queue.
+static bool saveBusy = false;			// Set while the saver is writing one it has taken from the queue.
+
+// Open a file on the disk to write its temporary file, or to read it. If the file isn't there but its temporary file
+// is, the game stopped while replacing it, so the temporary file is read instead.
+static bool fileOpen(struct storefile* f)
+{
+	if (f->write == true) { f->file = fopen(f->temp, "wb"); }
+	else
+	{
+		f->file = fopen(f->path, "rb");
+		if (f->file == NULL) { f->file = fopen(f->temp, "rb"); }
+	}
+	return f->file != NULL;
+}
+
+// Read from a file on the disk.
+static size_t fileRead(struct storefile* f, void* data, size_t bytes)
+{
+	return fread(data, 1, bytes, f->file);
+}
+
+// Write to a file's temporary file on the disk.
+static size_t fileWrite(struct storefile* f, const void* data, size_t bytes)
+{
+	size_t written = fwrite(data, 1, bytes, f->file);	// Bytes written.
+
+	if (written != bytes) { f->failed = true; }
+	return written;
+}
+
+// Close a file on the disk, return false if any of the temporary file couldn't be written, removing it.
+static bool fileFinish(struct storefile* f)
+{
+	if ((f->write == true) && (fflush(f->file) != 0)) { f->failed = true; }
+	if (fclose(f->file) != 0) { f->failed = true; }
+	if ((f->write == true) && (f->failed == true)) { remove(f->temp); }
+	return f->failed == false;
+}
+
+// Replace a file on a PC with its temporary file, rename does this in one go.
+static bool fileCommit(struct storefile* f)
+{
+	if (fileFinish(f) == false) { return false; }
+	return (f->write == false) || (rename(f->temp, f->path) == 0);
+}
+
+// Replace a file on the SD card with its temporary file. If the SD card can't rename over a file, the old file is
+// removed first, fileOpen reads the temporary file if the game stops in between.
+static bool sdCommit(struct storefile* f)
+{
+	if (fileFinish(f) == false) { return false; }
+	if ((f->write == false) || (rename(f->temp, f->path) == 0)) { return true; }
+	remove(f->path);
+	return rename(f->temp, f->path) == 0;
+}
+
+// Close a file on the disk, removing anything written.
+static void fileClose(struct storefile* f)
+{
+	fclose(f->file);
+	if (f->write == true) { remove(f->temp); }
+}
+
+// Remove a file on the disk, along with any temporary file left from replacing it.
+static void fileRemove(const char* path, const char* temp)
+{
+	remove(path);
+	remove(temp);
+}
+
+// Get the bytes in a file on the disk, or in the temporary file if the game stopped while replacing it.
+static size_t fileSize(const char* path, const char* temp)
+{
+	FILE* file = fopen(path, "rb");		// File measured.
+	long bytes;
+
+	if (file == NULL) { file = fopen(temp, "rb"); }
+	if (file == NULL) { return 0; }
+	bytes = (fseek(file, 0, SEEK_END) == 0) ? ftell(file) : 0;
+	fclose(file);
+	return (bytes > 0) ? (size_t)bytes : 0;
+}
+
+// Add to the end of a file on the disk.
+static bool fileAppend(const char* path, const void* data, size_t bytes)
+{
+	FILE* file = fopen(path, "ab");		// File added to.
+	bool ok;
+
+	if (file == NULL) { return false; }
+	ok = (fwrite(data, 1, bytes, file) == bytes);
+	if (fclose(file) != 0) { ok = false; }
+	return ok;
+}
+
+// Find a file kept in memory, return NULL if there isn't one. Call with memLock held.
+static struct memfile* memFind(const char* path)
+{
+	for (unsigned int i = 0; i < MEMFILES; i++)
+	{
+		if ((memFiles[i].path[0] != '\0') && (strcmp(memFiles[i].path, path) == 0)) { return &memFiles[i]; }
+	}
+	return NULL;
+}
+
+// Open a file kept in memory. Writing starts with nothing, reading takes a copy of the file.
+static bool memOpen(struct storefile* f)
+{
+	struct memfile* mf;					// File kept in memory.
+
+	if (f->write == true) { return true; }
+	lockMutex(&memLock);
+	mf = memFind(f->path);
+	if (mf != NULL)
+	{
+		f->data = malloc((mf->bytes > 0) ? mf->bytes : 1);
+		if (f->data != NULL)
+		{
+			memcpy(f->data, mf->data, mf->bytes);
+			f->bytes = mf->bytes;
+		}
+	}
+	unlockMutex(&memLock);
+	return f->data != NULL;
+}
+
+// Read from the copy of a file kept in memory.
+static size_t memRead(struct storefile* f, void* data, size_t bytes)
+{
+	if (bytes > (f->bytes - f->pos)) { bytes = f->bytes - f->pos; }
+	memcpy(data, f->data + f->pos, bytes);
+	f->pos += bytes;
+	return bytes;
+}
+
+// Write to a file in memory, doubling the memory for it when it runs out.
+static size_t memWrite(struct storefile* f, const void* data, size_t bytes)
+{
+	unsigned char* grown;				// Grown memory for the file.
+	size_t size;						// New size of the memory.
+
+	if ((f->bytes + bytes) > f->size)
+	{
+		size = (f->size * 2 > f->bytes + bytes) ? f->size * 2 : f->bytes + bytes;
+		grown = realloc(f->data, size);
+		if (grown == NULL)
+		{
+			f->failed = true;
+			return 0;
+		}
+		f->data = grown;
+		f->size = size;
+	}
+	memcpy(f->data + f->bytes, data, bytes);
+	f->bytes += bytes;
+	return bytes;
+}
+
+// Close a file in memory. If it was written, it replaces the file kept, unless there is no room for another file.
+static bool memCommit(struct storefile* f)
+{
+	struct memfile* mf;					// File kept in memory.
+
+	if ((f->write == false) || (f->failed == true))
+	{
+		free(f->data);
+		return f->failed == false;
+	}
+
+	lockMutex(&memLock);
+	mf = memFind(f->path);
+	for (unsigned int i = 0; (mf == NULL) && (i < MEMFILES); i++)
+	{
+		if (memFiles[i].path[0] == '\0')
+		{
+			mf = &memFiles[i];
+			strcpy(mf->path, f->path);
+			mf->data = NULL;
+		}
+	}
+	if (mf != NULL)
+	{
+		free(mf->data);
+		mf->data = f->data;
+		mf->bytes = f->bytes;
+		f->data = NULL;
+	}
+	unlockMutex(&memLock);
+
+	free(f->data);
+	return mf != NULL;
+}
+
+// Close a file in memory, forgetting anything written.
+static void memClose(struct storefile* f)
+{
+	free(f->data);
+}
+
+// Add to the end of a file kept in memory, making it if it isn't there.
+static bool memAppend(const char* path, const void* data, size_t bytes)
+{
+	struct memfile* mf;					// File kept in memory.
+	unsigned char* grown;				// Grown memory for the file.
+
+	lockMutex(&memLock);
+	mf = memFind(path);
+	for (unsigned int i = 0; (mf == NULL) && (i < MEMFILES); i++)
+	{
+		if (memFiles[i].path[0] == '\0')
+		{
+			mf = &memFiles[i];
+			strcpy(mf->path, path);
+			mf->data = NULL;
+			mf->bytes = 0;
+		}
+	}
+	grown = (mf != NULL) ? realloc(mf->data, mf->bytes + bytes) : NULL;
+	if (grown != NULL)
+	{
+		memcpy(grown + mf->bytes, data, bytes);
+		mf->data = grown;
+		mf->bytes += bytes;
+	}
+	unlockMutex(&memLock);
+	return grown != NULL;
+}
+
+// Get the bytes in a file kept in memory.
+static size_t memSize(const char* path, const char* temp)
+{
+	struct memfile* mf;					// File kept in memory.
+	size_t bytes = 0;
+
+	(void)temp;							// Files kept in memory are replaced in one go, there is no temporary file.
+	lockMutex(&memLock);
+	mf = memFind(path);
+	if (mf != NULL) { bytes = mf->bytes; }
+	unlockMutex(&memLock);
+	return bytes;
+}
+
+// Remove a file kept in memory.
+static void memRemove(const char* path, const char* temp)
+{
+	struct memfile* mf;					// File kept in memory.
+
+	(void)temp;							// Files kept in memory are replaced in one go, there is no temporary file.
+	lockMutex(&memLock);
+	mf = memFind(path);
+	if (mf != NULL)
+	{
+		free(mf->data);
+		mf->data = NULL;
+		mf->path[0] = '\0';
+	}
+	unlockMutex(&memLock);
+}
+
+// The ways of keeping files, in the order of enum STORAGE.
+static const struct
+{
+	bool (*open)(struct storefile* f);	// Open the file, return false if it can't be opened.
+	size_t (*read)(struct storefile* f, void* data, size_t bytes);	// Read from the file.
+	size_t (*write)(struct storefile* f, const void* data, size_t bytes);	// Write to the file.
+	bool (*commit)(struct storefile* f);	// Close the file and replace the old file with what was written.
+	void (*close)(struct storefile* f);	// Close the file and forget what was written.
+	void (*remove)(const char* path, const char* temp);	// Remove a file and any temporary file.
+	bool (*append)(const char* path, const void* data, size_t bytes);	// Add to the end of a file.
+	size_t (*size)(const char* path, const char* temp);	// Get the bytes in a file, 0 if it isn't there.
+} backends[STORAGECOUNT] =
+{
+	{ fileOpen, fileRead, fileWrite, sdCommit, fileClose, fileRemove, fileAppend, fileSize },		// STORAGESD
+	{ fileOpen, fileRead, fileWrite, fileCommit, fileClose, fileRemove, fileAppend, fileSize },	// STORAGEFILES
+	{ memOpen, memRead, memWrite, memCommit, memClose, memRemove, memAppend, memSize },			// STORAGEMEMORY
+};
+
+// Choose how files are kept and find the game's directory under the working directory. Only the first call counts, so
+// call this at the start before any file is used. Otherwise the first file used starts storage with the platform's files.
+void startStorage(storage_t kind)
+{
+	unsigned int expected = 0;			// Storage not started yet.
+
+	if (atomic_compare_exchange_strong(&started, &expected, 1) == false)
+	{
+		// Another thread may be starting it, wait for it to finish.
+		while (atomic_load(&started) != 2) { }
+		return;
+	}
+
+	storage = (kind < STORAGECOUNT) ? kind : STORAGEFILES;
+	if (getcwd(root, sizeof(root) - sizeof(STORAGEDIR)) == NULL) { root[0] = '\0'; }
+	strcat(root, STORAGEDIR);
+	initMutex(&memLock);
+	initMutex(&saveLock);
+	initEvent(&saveWake);
+	initEvent(&saveDone);
+	atomic_store(&started, 2);
+}
+
+// Start storage with the platform's files, if it hasn't been started.
+static void checkStarted(void)
+{
+	if (atomic_load(&started) == 2) { return; }
+#ifdef __WIIU__
+	startStorage(STORAGESD);
+#else
+	startStorage(STORAGEFILES);
+#endif
+}
+
+// Return how files are kept.
+storage_t getStorage()
+{
+	checkStarted();
+	return storage;
+}
+
+// Put the full path to a file in path, which has room for STORAGEPATH characters. Names are in the game's directory,
+// unless they are full paths already.
+const char* storagePath(const char* name, char* path)
+{
+	checkStarted();
+	if ((name[0] == '/') || (strchr(name, ':') != NULL)) { snprintf(path, STORAGEPATH, "%s", name); }
+	else { snprintf(path, STORAGEPATH, "%s%s", root, name); }
+	return path;
+}
+
+// Wait until the saver has written everything queued, so files read back what was last written.
+static void waitSaved(void)
+{
+	checkStarted();
+	lockMutex(&saveLock);
+	while ((saveCount > 0) || (saveBusy == true))
+	{
+		unlockMutex(&saveLock);
+		waitEvent(&saveDone);
+		lockMutex(&saveLock);
+	}
+	unlockMutex(&saveLock);
+}
+
+// Open a file to read, or to write in place of the file once committed. Return NULL if it can't be opened.
+// Reading waits for any writes queued first.
+struct storefile* storageOpen(const char* name, bool write)
+{
+	struct storefile* f;				// File opened.
+
+	if (write == false) { waitSaved(); }
+	f = calloc(1, sizeof(struct storefile));
+	if (f == NULL) { return NULL; }
+	storagePath(name, f->path);
+	sprintf(f->temp, "%s.tmp", f->path);
+	f->write = write;
+	if (backends[storage].open(f) == false)
+	{
+		free(f);
+		return NULL;
+	}
+	return f;
+}
+
+// Read up to bytes from the file, return the bytes read.
+size_t storageRead(struct storefile* f, void* data, size_t bytes)
+{
+	if ((f == NULL) || (f->write == true)) { return 0; }
+	return backends[storage].read(f, data, bytes);
+}
+
+// Write bytes to the file, return the bytes written.
+size_t storageWrite(struct storefile* f, const void* data, size_t bytes)
+{
+	if ((f == NULL) || (f->write == false)) { return 0; }
+	return backends[storage].write(f, data, bytes);
+}
+
+// Close the file. If it was written, replace the old file with it in one go. Return false if any of it couldn't be
+// written, in which case the old file is kept.
+bool storageCommit(struct storefile* f)
+{
+	bool ok;
+
+	if (f == NULL) { return false; }
+	ok = backends[storage].commit(f);
+	free(f);
+	return ok;
+}
+
+// Close the file, forgetting anything written to it.
+void storageClose(struct storefile* f)
+{
+	if (f == NULL) { return; }
+	backends[storage].close(f);
+	free(f);
+}
+
+// Remove a file, and any temporary file left from replacing it.
+void storageRemove(const char* name)
+{
+	char path[STORAGEPATH];
+	char temp[STORAGEPATH + 4];
+
+	waitSaved();
+	storagePath(name, path);
+	sprintf(temp, "%s.tmp", path);
+	backends[storage].remove(path, temp);
+}
+
+// Return the bytes in a file, 0 if it isn't there, after any writes queued.
+size_t storageSize(const char* name)
+{
+	char path[STORAGEPATH];
+	char temp[STORAGEPATH + 4];
+
+	waitSaved();
+	storagePath(name, path);
+	sprintf(temp, "%s.tmp", path);
+	return backends[storage].size(path, temp);
+}
+
+// Add to the end of a file, making it if it isn't there. Return false if this fails.
+bool storageAppend(const char* name, const void* data, size_t bytes)
+{
+	char path[STORAGEPATH];
+
+	storagePath(name, path);
+	return backends[storage].append(path, data, bytes);
+}
+
+// Write a queued file, replacing it or adding to the end of it. Return false if this fails.
+static bool writeJob(const struct savejob* job)
+{
+	struct storefile* outFile;
+
+	if (job->append == true) { return storageAppend(job->name, job->data, job->bytes); }
+	outFile = storageOpen(job->name, true);
+	storageWrite(outFile, job->data, job->bytes);
+	return storageCommit(outFile);
+}
+
+// Saver thread, writes the files queued each time it is woken, oldest first, until it is stopped. The queue is always
+// emptied before stopping, so nothing queued is lost.
+static void saveThread(void* arg)
+{
+	struct savejob job;					// Write taken from the queue.
+
+	(void)arg;
+	while (true)
+	{
+		waitEvent(&saveWake);
+		lockMutex(&saveLock);
+		while (saveCount > 0)
+		{
+			job = jobs[saveHead];
+			saveHead = (saveHead + 1) % SAVEJOBS;
+			saveCount--;
+			saveBusy = true;
+			unlockMutex(&saveLock);
+
+			writeJob(&job);
+			free(job.data);
+
+			lockMutex(&saveLock);
+			saveBusy = false;
+			setEvent(&saveDone);
+		}
+		if (saveStop == true)
+		{
+			unlockMutex(&saveLock);
+			return;
+		}
+		unlockMutex(&saveLock);
+	}
+}
+
+// Queue a file to be written by the saver thread, replacing the file or adding to the end of it with append, so the
+// caller never waits for the disk. The data is copied. A file still waiting to be replaced is given the new data rather
+// than being written twice. If the queue is full this waits for the saver to make room. If there isn't the memory to
+// copy the data or the saver can't be started, the file is written here instead, and false is returned if that fails.
+bool storageQueue(const char* name, const void* data, size_t bytes, bool append)
+{
+	struct savejob job;					// Write queued.
+	bool ok;
+
+	checkStarted();
+	snprintf(job.name, sizeof(job.name), "%s", name);
+	job.bytes = bytes;
+	job.append = append;
+	job.data = malloc((bytes > 0) ? bytes : 1);
+	if (job.data == NULL)
+	{
+		job.data = (unsigned char*)data;
+		return writeJob(&job);
+	}
+	memcpy(job.data, data, bytes);
+
+	lockMutex(&saveLock);
+	if (saving == false)
+	{
+		saveStop = false;
+		saving = startThread(&saver, saveThread, NULL, SAVECORE);
+		if (saving == false)
+		{
+			unlockMutex(&saveLock);
+			ok = writeJob(&job);
+			free(job.data);
+			return ok;
+		}
+	}
+
+	// A file waiting to be replaced only needs the newest data.
+	for (unsigned int i = 0; (append == false) && (i < saveCount); i++)
+	{
+		struct savejob* waiting = &jobs[(saveHead + i) % SAVEJOBS];		// Write in the queue.
+
+		if ((waiting->append == false) && (strcmp(waiting->name, job.name) == 0))
+		{
+			free(waiting->data);
+			*waiting = job;
+			unlockMutex(&saveLock);
+			return true;
+		}
+	}
+
+	while (saveCount == SAVEJOBS)
+	{
+		unlockMutex(&saveLock);
+		waitEvent(&saveDone);
+		lockMutex(&saveLock);
+	}
+	jobs[(saveHead + saveCount) % SAVEJOBS] = job;
+	saveCount++;
+	unlockMutex(&saveLock);
+	setEvent(&saveWake);
+	return true;
+}
+
+// Wait for everything queued to be written, then stop the saver thread. It starts again when something else is queued.
+void storageFlush(void)
+{
+	checkStarted();
+	lockMutex(&saveLock);
+	if (saving == false)
+	{
+		unlockMutex(&saveLock);
+		return;
+	}
+	saveStop = true;
+	unlockMutex(&saveLock);
+	setEvent(&saveWake);
+	joinThread(&saver);
+	saving = false;
+}
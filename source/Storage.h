@@ -0,0 +1,52 @@
+#pragma once
+
+// Where the game keeps its files, such as the level, the replay and the snapshot of the level being played. The game
+// only uses the functions here, so the same game runs with its files on the Wii U SD card, in a directory on a PC, or
+// just in memory for tests and benchmarks that shouldn't touch the disk.
+
+#include <stdbool.h>					// For booleans.
+#include <stddef.h>						// For sizes.
+
+#define STORAGEPATH 1024				// Longest path to a file, including the directory of the game.
+#define STORAGEDIR  "/wiiu/apps/Labyrinth/"	// Directory of the game under the working directory.
+
+// A value from enum STORAGE.
+typedef unsigned int storage_t;
+
+// Ways the game's files can be kept.
+enum STORAGE
+{
+	STORAGESD     = 0,					// Files on the Wii U SD card, which can't rename over a file.
+	STORAGEFILES  = 1,					// Files on a PC, renamed over in one go.
+	STORAGEMEMORY = 2,					// Kept in memory, nothing is read from or written to the disk.
+	STORAGECOUNT  = 3,					// Number of ways of keeping files.
+};
+
+// A file opened with storageOpen, only used through these functions.
+struct storefile;
+
+void startStorage(storage_t kind);		// Choose how files are kept and find the game's directory. Call once at the start,
+										// before any file is used. Otherwise the first use picks files for the platform.
+storage_t getStorage(void);				// Return how files are kept.
+const char* storagePath(const char* name, char* path);	// Put the full path to a file in the game's directory in path,
+										// which has room for STORAGEPATH characters, and return it. Names starting with
+										// '/' or a device (such as "fs:/") are full paths already.
+
+struct storefile* storageOpen(const char* name, bool write);	// Open a file to read, or to write in place of the file
+										// once committed. Return NULL if there is no such file or it can't be written.
+size_t storageRead(struct storefile* f, void* data, size_t bytes);	// Read from the file, return the bytes read.
+size_t storageWrite(struct storefile* f, const void* data, size_t bytes);	// Write to the file, return the bytes written.
+bool storageCommit(struct storefile* f);	// Close the file, replacing the old file in one go with what was written. Return
+										// false if any of it couldn't be written, in which case the old file is kept.
+void storageClose(struct storefile* f);	// Close the file, forgetting anything written to it.
+bool storageAppend(const char* name, const void* data, size_t bytes);	// Add to the end of a file, making the file if
+										// it isn't there, for logs that are only added to. Return false if this fails.
+void storageRemove(const char* name);	// Remove a file, if it is there.
+size_t storageSize(const char* name);	// Return the bytes in a file, 0 if it isn't there.
+
+// Writes queued for the saver thread, for files written while the game is being played. Reading a file, removing it or
+// finding its size waits for everything queued to be written first. Call these from the game's thread.
+bool storageQueue(const char* name, const void* data, size_t bytes, bool append);	// Replace a file with a copy of
+										// data, or add it to the end of the file with append, in the background. Return
+										// false only if it had to be written straight away and that failed.
+void storageFlush(void);				// Wait for everything queued to be written, call before the game exits.
@@ -0,0 +1,202 @@
+// Threads for work that can be done alongside the game, such as making the next maze or saving the level.
+// The Wii U version uses coreinit threads so work can be put on another core, other builds use pthreads.
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE				// For pinning threads to cores on Linux.
+#endif
+
+#include <stdlib.h>				// For free.
+#ifdef __WIIU__
+#include <malloc.h>				// For memalign.
+#else
+#include <unistd.h>				// For the number of cores.
+#endif
+
+#include "Threads.h"			// For the thread API.
+
+#ifdef __WIIU__
+
+// Wii U thread entry, the thread is passed in as argv.
+static int threadEntry(int argc, const char** argv)
+{
+	struct thread* t = (struct thread*)argv;
+
+	t->func(t->arg);
+	return 0;
+}
+
+// Start a thread on a core, at a lower priority than the game so it doesn't hold up the display.
+bool startThread(struct thread* t, void (*func)(void* arg), void* arg, unsigned int core)
+{
+	t->func = func;
+	t->arg = arg;
+	t->os = memalign(16, sizeof(OSThread));
+	t->stack = memalign(16, THREADSTACK);
+	if ((t->os == NULL) || (t->stack == NULL))
+	{
+		free(t->os);
+		free(t->stack);
+		return false;
+	}
+
+	// The stack grows down, so the top of the stack memory is passed in.
+	if (OSCreateThread(t->os, threadEntry, 0, (char*)t, t->stack + THREADSTACK, THREADSTACK, 20,
+		(OSThreadAttributes)(OS_THREAD_ATTRIB_AFFINITY_CPU0 << (core % threadCores()))) == FALSE)
+	{
+		free(t->os);
+		free(t->stack);
+		return false;
+	}
+	OSResumeThread(t->os);
+	return true;
+}
+
+// The Wii U has three cores, the game runs on core 1.
+unsigned int threadCores(void)
+{
+	return 3;
+}
+
+// Wait for the thread to finish, then free its memory.
+void joinThread(struct thread* t)
+{
+	int result;		// Thread return value, not used.
+
+	OSJoinThread(t->os, &result);
+	free(t->os);
+	free(t->stack);
+}
+
+// Set up an event that clears itself when the waiting thread wakes.
+void initEvent(struct event* e)
+{
+	OSInitEvent(&e->os, FALSE, OS_EVENT_MODE_AUTO);
+}
+
+// Set the event, waking the waiting thread.
+void setEvent(struct event* e)
+{
+	OSSignalEvent(&e->os);
+}
+
+// Wait for the event to be set, it is cleared as the thread wakes.
+void waitEvent(struct event* e)
+{
+	OSWaitEvent(&e->os);
+}
+
+// Set up a mutex, it starts unlocked.
+void initMutex(struct mutex* m)
+{
+	OSInitMutex(&m->os);
+}
+
+// Wait for the mutex and take it.
+void lockMutex(struct mutex* m)
+{
+	OSLockMutex(&m->os);
+}
+
+// Let the mutex go.
+void unlockMutex(struct mutex* m)
+{
+	OSUnlockMutex(&m->os);
+}
+
+#else
+
+// pthread entry, the thread is passed in as the argument.
+static void* threadEntry(void* arg)
+{
+	struct thread* t = (struct thread*)arg;
+
+	t->func(t->arg);
+	return NULL;
+}
+
+// Start a thread pinned to a core on Linux, elsewhere the core is left to the operating system. If the core can't be
+// used, for example as the process is kept to fewer cores, the thread is started unpinned.
+bool startThread(struct thread* t, void (*func)(void* arg), void* arg, unsigned int core)
+{
+#ifdef __linux__
+	pthread_attr_t attr;	// Attributes pinning the thread.
+	cpu_set_t cores;		// Core the thread is pinned to.
+	bool started;			// Set if the pinned thread was started.
+#endif
+
+	t->func = func;
+	t->arg = arg;
+#ifdef __linux__
+	CPU_ZERO(&cores);
+	CPU_SET(core % threadCores(), &cores);
+	started = (pthread_attr_init(&attr) == 0);
+	if (started == true)
+	{
+		started = (pthread_attr_setaffinity_np(&attr, sizeof(cores), &cores) == 0) &&
+				  (pthread_create(&t->id, &attr, threadEntry, t) == 0);
+		pthread_attr_destroy(&attr);
+	}
+	if (started == true) { return true; }
+#endif
+	return pthread_create(&t->id, NULL, threadEntry, t) == 0;
+}
+
+// Cores the operating system has online, at least one.
+unsigned int threadCores(void)
+{
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);	// Cores online, -1 if it isn't known.
+
+	return (cores > 0) ? (unsigned int)cores : 1;
+}
+
+// Wait for the thread to finish.
+void joinThread(struct thread* t)
+{
+	pthread_join(t->id, NULL);
+}
+
+// Set up an event, it starts clear.
+void initEvent(struct event* e)
+{
+	pthread_mutex_init(&e->lock, NULL);
+	pthread_cond_init(&e->cond, NULL);
+	e->set = false;
+}
+
+// Set the event, waking the waiting thread.
+void setEvent(struct event* e)
+{
+	pthread_mutex_lock(&e->lock);
+	e->set = true;
+	pthread_cond_signal(&e->cond);
+	pthread_mutex_unlock(&e->lock);
+}
+
+// Wait for the event to be set, then clear it.
+void waitEvent(struct event* e)
+{
+	pthread_mutex_lock(&e->lock);
+	while (e->set == false) { pthread_cond_wait(&e->cond, &e->lock); }
+	e->set = false;
+	pthread_mutex_unlock(&e->lock);
+}
+
+// Set up a mutex, it starts unlocked.
+void initMutex(struct mutex* m)
+{
+	pthread_mutex_init(&m->lock, NULL);
+}
+
+// Wait for the mutex and take it.
+void lockMutex(struct mutex* m)
+{
+	pthread_mutex_lock(&m->lock);
+}
+
+// Let the mutex go.
+void unlockMutex(struct mutex* m)
+{
+	pthread_mutex_unlock(&m->lock);
+}
+
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+// The function interface to start and wait for threads, events and mutexes, the same on the Wii U and on a PC.
+
+#include <stdbool.h>			// For booleans.
+
+#ifdef __WIIU__
+#include <coreinit/thread.h>	// For Wii U threads.
+#include <coreinit/event.h>		// For Wii U events.
+#include <coreinit/mutex.h>		// For Wii U mutexes.
+#else
+#include <pthread.h>			// For threads on a PC.
+#endif
+
+#define THREADSTACK 0x10000		// Stack size for each thread on the Wii U.
+
+// A thread started with startThread, only used through these functions.
+struct thread
+{
+#ifdef __WIIU__
+	OSThread* os;				// Wii U thread, allocated as it must be aligned.
+	unsigned char* stack;		// Stack for the thread.
+#else
+	pthread_t id;				// PC thread.
+#endif
+	void (*func)(void* arg);	// Function run by the thread.
+	void* arg;					// Argument passed to the function.
+};
+
+// Call this to run func(arg) on a new thread, pinned to core % threadCores(). On a PC the thread is only pinned where
+// the system supports it (Linux), elsewhere the core is left to the operating system.
+// Returns false if the thread couldn't be started, in which case func has not been called.
+extern bool startThread(struct thread* t, void (*func)(void* arg), void* arg, unsigned int core);
+
+// Call this to get how many cores threads can be put on, 3 on the Wii U.
+extern unsigned int threadCores(void);
+
+// Call this once for each thread started, to wait for func to return and tidy up the thread.
+extern void joinThread(struct thread* t);
+
+// An event one thread waits for and another sets, only used through these functions. Setting it wakes the waiting
+// thread, or the next one to wait if none is waiting yet. It is cleared again when the waiting thread wakes, so setting
+// it several times before then only wakes the thread once.
+struct event
+{
+#ifdef __WIIU__
+	OSEvent os;					// Wii U event, set to clear itself when a thread wakes.
+#else
+	pthread_mutex_t lock;		// Lock for the flag.
+	pthread_cond_t cond;		// Signalled when the flag is set.
+	bool set;					// Set until the waiting thread wakes.
+#endif
+};
+
+// Call this once to set up an event before it is used, it starts clear.
+extern void initEvent(struct event* e);
+
+// Call this to set the event, waking the thread waiting for it.
+extern void setEvent(struct event* e);
+
+// Call this to wait until the event is set, then clear it.
+extern void waitEvent(struct event* e);
+
+// A mutex letting one thread at a time use something shared, only used through these functions.
+struct mutex
+{
+#ifdef __WIIU__
+	OSMutex os;					// Wii U mutex.
+#else
+	pthread_mutex_t lock;		// PC mutex.
+#endif
+};
+
+// Call this once to set up a mutex before it is used, it starts unlocked.
+extern void initMutex(struct mutex* m);
+
+// Call this to wait until no other thread has the mutex, then take it.
+extern void lockMutex(struct mutex* m);
+
+// Call this to let the mutex go, once done with what it protects.
+extern void unlockMutex(struct mutex* m);
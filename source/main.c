@@ -2,24 +2,60 @@
 #include <stdio.h>				// For sprintf.
 #include <stdbool.h>			// For booleans.
 
+#ifdef __WIIU__
 #include <coreinit/screen.h>	// For OSScreen.
 #include <coreinit/thread.h>	// For Sleep.
+#include <coreinit/time.h>		// For the time to seed the first maze.
 #include <vpad/input.h>			// For the game pad inputs.
 #include <whb/proc.h>			// For the loop and to do home button correctly.
+#include <proc_ui/procui.h>		// For saving the level being played when the game goes to the background.
 #include <whb/log.h>			// ** Using the console logging features seems to help set up the screen output.
 #include <whb/log_console.h>	// ** Found neeeded to keep these in the build for the program to display properly.
+#else
+#include "Headless.h"			// For the gamepad and time when running the game states headless on a PC.
+#endif
 
 #include "Labyrinth.h"			// Header for the game processing.
+#ifdef __WIIU__
 #include "Draw.h"				// For graphics.
+#endif
 #include "Sounds.h"				// For game sound.
+#include "Replay.h"				// For recording and replaying games.
+#include "Input.h"				// For reading the gamepad every frame.
+#include "Storage.h"			// For where the game's files are kept.
+#include "RunLog.h"				// For the log of levels completed.
 
 #define GREEN 0x00FE0000		// Green colour used t give green screen effect.
 
-static unsigned int gameState = 0;	// 0 start, 1 playing, 2 new level, 3 end.
-static char move = 0;				// The player move to pass into the game.
-static unsigned int animate = 0;	// Count used for animation sequencing.
-bool doMap = false;					// Flag to show if map display is enabled.
-static unsigned int colour = 0;		// Used to fade text in.
+// State of the game screens, kept together rather than in separate globals. The maze and player are in the game.
+struct play
+{
+	unsigned int gameState;			// 0 start, 1 playing, 2 new level, 3 end.
+	char move;						// The player move to pass into the game.
+	unsigned int animate;			// Count used for animation sequencing.
+	bool doMap;						// Flag to show if map display is enabled.
+	bool autoSolve;					// Flag to show if the game is walking the player to the exit.
+	unsigned int colour;			// Used to fade text in.
+	OSTime levelTime;				// Time the new level screen was started.
+	OSTime levelStart;				// Time the level being played was started, less any time in the background.
+	OSTime pausedAt;				// Time the game went to the background.
+	bool resumed;					// Set when the level from the last launch has been carried on, until A plays it.
+	unsigned int resumeMs;			// Time already played on the level carried on, in milliseconds.
+	unsigned int moves;				// Moves forward made on the level being played.
+	unsigned int turns;				// Turns made on the level being played.
+	bool solved;					// Set if auto-solve has made any of the moves on the level being played.
+	bool carriedOn;					// Set if the level being played was carried on from the last launch.
+};
+
+static struct play play = { 0 };	// The game screens being played.
+
+// Return the game state, 0 start, 1 playing, 2 new level, 3 end. For running the game states headless.
+unsigned int getGameState()
+{
+	return play.gameState;
+}
+
+#ifdef __WIIU__
 
 // Put a border round the 3D display to make a neat edge.
 void drawBorder()
@@ -57,10 +93,13 @@ void drawOuterBorder()
 void vpadDisplay()
 {
 	char slevel[100] = "\0";	// String to display the current level.
+	char ssolve[100] = "\0";	// String to display the moves left to the exit.
 
 	OSScreenClearBufferEx(SCREEN_DRC, 0x00000000u);	// Black background on gamepad.
 
-	sprintf(slevel, "Level %i of %i", getLevel(), MAXLEVEL); // Current game level.
+	// Current game level, endless mode has no top level.
+	if (getEndless() == true) { sprintf(slevel, "Level %i (endless)", getLevel()); }
+	else { sprintf(slevel, "Level %i of %i", getLevel(), MAXLEVEL); }
 
 	// Put the text elements on the gamepad screen, showing which controller buttons to use and current level.
 	// Use an old school green screen look.
@@ -75,6 +114,14 @@ void vpadDisplay()
 	drawText("Left  - turn left\0", GREEN, 2, 10, 240, SCREEN_DRC);
 	drawText("Right - turn right\0", GREEN, 2, 10, 270, SCREEN_DRC);
 	drawText("X     - enable/disable map view\0", GREEN, 2, 10, 330, SCREEN_DRC);
+	drawText("Y     - enable/disable auto-solve\0", GREEN, 2, 10, 360, SCREEN_DRC);
+
+	// While auto-solve is on show how far there is to go, this is a lookup so it can be done every frame.
+	if ((play.autoSolve == true) && (getDistanceToExit() > 0))
+	{
+		sprintf(ssolve, "Auto-solve: %u moves to the exit", getDistanceToExit());
+		drawText(ssolve, GREEN, 2, 10, 410, SCREEN_DRC);
+	}
 
 	OSScreenFlipBuffersEx(SCREEN_DRC);
 }
@@ -83,18 +130,44 @@ void vpadDisplay()
 void displayStartScreen()
 {
 	char slevel[100] = "\0";	// String to display the current level.
+	char smaze[100] = "\0";	// String to display the maze generator.
+	char smode[100] = "\0";	// String to display the maze shape.
+	char sseed[100] = "\0";	// String to display the maze code.
+	char sbest[100] = "\0";	// String to display the best time for the level.
+	unsigned int best;			// Best time for the level in milliseconds, 0 if there isn't one.
 
 	sprintf(slevel, "Level %i ", getLevel()); // Current game level.
 
-	drawText("Welcome to the Labyrinth!\0", colour, 3, 50, 50, SCREEN_TV);
-	drawText("Press A to continue\0", colour, 3, 50, 100, SCREEN_TV);
-	drawText("Press ZL and ZR to start again\0", colour, 3, 50, 150, SCREEN_TV);
+	drawText("Welcome to the Labyrinth!\0", play.colour, 3, 50, 50, SCREEN_TV);
+	if (play.resumed == true) { drawText("Press A to carry on where you were\0", play.colour, 3, 50, 100, SCREEN_TV); }
+	else { drawText("Press A to continue\0", play.colour, 3, 50, 100, SCREEN_TV); }
+	drawText("Press ZL and ZR to start again\0", play.colour, 3, 50, 150, SCREEN_TV);
+	if (getEndless() == true) { drawText("Press Y for normal mode\0", play.colour, 3, 50, 200, SCREEN_TV); }
+	else { drawText("Press Y for endless mode\0", play.colour, 3, 50, 200, SCREEN_TV); }
 
-	drawText(slevel, colour, 3, 50, 250, SCREEN_TV);
+	drawText(slevel, play.colour, 3, 50, 250, SCREEN_TV);
+
+	sprintf(smaze, "Press B to change maze: %s", getGeneratorName(getGenerator())); // Maze generator selected.
+	drawText(smaze, play.colour, 3, 50, 300, SCREEN_TV);
+	sprintf(smode, "Press X to change shape: %s", getModeName(getMode())); // Maze shape selected.
+	drawText(smode, play.colour, 3, 50, 350, SCREEN_TV);
+
+	sprintf(sseed, "Maze code %08X", getSeed()); // Seed for the next maze, so the same maze can be shared and played again.
+	drawText("Press R to replay the last game\0", play.colour, 3, 50, 400, SCREEN_TV);
+	drawText(sseed, play.colour, 3, 50, 450, SCREEN_TV);
+
+	// Best time for the level and the kind of maze about to be played, from the log of levels completed. It is looked up
+	// in the index so it costs nothing each frame.
+	best = getBestTime(getMode(), getNextGenerator(), getEndless(), getLevel());
+	if (best > 0)
+	{
+		sprintf(sbest, "Best time %u:%02u.%u", best / 60000, (best / 1000) % 60, (best / 100) % 10);
+		drawText(sbest, play.colour, 3, 50, 500, SCREEN_TV);
+	}
 
 	// increase colour but limit to green to fade text in.
-	colour = colour + 0x00040000u;
-	if (colour > GREEN) { colour = GREEN;  }
+	play.colour = play.colour + 0x00040000u;
+	if (play.colour > GREEN) { play.colour = GREEN;  }
 }
 
 // Display to show next level.
@@ -111,13 +184,13 @@ void displayLevelScreen()
 // Display the reached the end of the game.
 void displayEndScreen()
 {
-	drawText("Congratulations!\0", colour, 3, 50, 50, SCREEN_TV);
-	drawText("You escaped the Labyrinth!\0", colour, 3, 50, 100, SCREEN_TV);
-	drawText("Press B\0", colour, 3, 50, 150, SCREEN_TV);
+	drawText("Congratulations!\0", play.colour, 3, 50, 50, SCREEN_TV);
+	drawText("You escaped the Labyrinth!\0", play.colour, 3, 50, 100, SCREEN_TV);
+	drawText("Press B\0", play.colour, 3, 50, 150, SCREEN_TV);
 
 	// increase colour but limit to green to fade text in.
-	colour = colour + 0x00040000u;
-	if (colour > GREEN) { colour = GREEN; }
+	play.colour = play.colour + 0x00040000u;
+	if (play.colour > GREEN) { play.colour = GREEN; }
 }
 
 // Function to display the current postion and area of 5 blocks in all directions.
@@ -149,14 +222,14 @@ void displayMaze3D()
 	float y2 = 0.0f;
 
 	// Shift the image to give the impression of turning for left and right.
-	if ((move == 'r') && (animate == 1)) { xoff =  XDISPMAX * 0.8f; }
-	if ((move == 'r') && (animate == 2)) { xoff =  XDISPMAX * 0.6f; }
-	if ((move == 'r') && (animate == 3)) { xoff =  XDISPMAX * 0.4f; }
-	if ((move == 'r') && (animate == 4)) { xoff =  XDISPMAX * 0.2f; }
-	if ((move == 'l') && (animate == 1)) { xoff = -XDISPMAX * 0.8f; }
-	if ((move == 'l') && (animate == 2)) { xoff = -XDISPMAX * 0.6f; }
-	if ((move == 'l') && (animate == 3)) { xoff = -XDISPMAX * 0.4f; }
-	if ((move == 'l') && (animate == 4)) { xoff = -XDISPMAX * 0.2f; }
+	if ((play.move == 'r') && (play.animate == 1)) { xoff =  XDISPMAX * 0.8f; }
+	if ((play.move == 'r') && (play.animate == 2)) { xoff =  XDISPMAX * 0.6f; }
+	if ((play.move == 'r') && (play.animate == 3)) { xoff =  XDISPMAX * 0.4f; }
+	if ((play.move == 'r') && (play.animate == 4)) { xoff =  XDISPMAX * 0.2f; }
+	if ((play.move == 'l') && (play.animate == 1)) { xoff = -XDISPMAX * 0.8f; }
+	if ((play.move == 'l') && (play.animate == 2)) { xoff = -XDISPMAX * 0.6f; }
+	if ((play.move == 'l') && (play.animate == 3)) { xoff = -XDISPMAX * 0.4f; }
+	if ((play.move == 'l') && (play.animate == 4)) { xoff = -XDISPMAX * 0.2f; }
 
 	// Calculate the x and y coming in from the corners based on the screen split between corridor and sides.
 	x2 = ((float)XDISPMAX * split);	// x working variable set to the corridor position.
@@ -168,25 +241,25 @@ void displayMaze3D()
 	// The reduction for perspective is 1/3 per block and the animation is in 5 steps, hence the use of 15ths.
 	// As we have moved the x2 and y2 positions in for animation, the splt needs to be proprtionally reduced.
 	// The display constants are integers, everything must be explicitly shown as floats to avoid the calculations being reduced to integers.
-	if ((move == 'f') && (animate == 1)) 
+	if ((play.move == 'f') && (play.animate == 1)) 
 	{ 
 		x2 = ((float)XDISPMAX * split) + ((split * 8.0f / 15.0f) * (float)XDISPMAX);
 		y2 = ((float)YDISPMAX * split) + ((split * 8.0f / 15.0f) * (float)YDISPMAX);
 		split = split * (11.0f / 15.0f);
 	}
-	if ((move == 'f') && (animate == 2))
+	if ((play.move == 'f') && (play.animate == 2))
 	{
 		x2 = ((float)XDISPMAX * split) + ((split * 6.0f / 15.0f) * (float)XDISPMAX);
 		y2 = ((float)YDISPMAX * split) + ((split * 6.0f / 15.0f) * (float)YDISPMAX);
 		split = split * (12.0f / 15.0f);
 	}
-	if ((move == 'f') && (animate == 3))
+	if ((play.move == 'f') && (play.animate == 3))
 	{
 		x2 = ((float)XDISPMAX * split) + ((split * 4.0f / 15.0f) * (float)XDISPMAX);
 		y2 = ((float)YDISPMAX * split) + ((split * 4.0f / 15.0f) * (float)YDISPMAX);
 		split = split * (13.0f / 15.0f);
 	}
-	if ((move == 'f') && (animate == 4))
+	if ((play.move == 'f') && (play.animate == 4))
 	{
 		x2 = ((float)XDISPMAX * split) + ((split * 2.0f / 15.0f) * (float)XDISPMAX);
 		y2 = ((float)YDISPMAX * split) + ((split * 2.0f / 15.0f) * (float)YDISPMAX);
@@ -254,14 +327,14 @@ void displays()     // Function to handle the displays.
 	drawOuterBorder(); // Put a border round the entire TV screen.
 
 	// Call the correct display function based on game state.
-	switch (gameState)
+	switch (play.gameState)
 	{
 		case 0: { displayStartScreen(); break; }
 		case 2: { displayLevelScreen(); break; }
 		case 3: { displayEndScreen(); break; }
 		default: {
 			drawBorder();							// Border for the 3D display area.
-			if (doMap == true) { displayMaze2D(); } // Display 2D map if enabled.
+			if (play.doMap == true) { displayMaze2D(); } // Display 2D map if enabled.
 			displayMaze3D();						// Display the 3D view of the current maze position.
 		}
 	}
@@ -270,123 +343,266 @@ void displays()     // Function to handle the displays.
     OSScreenFlipBuffersEx(SCREEN_TV);
 	return;
 }
+#endif
+
+// Start timing a level and counting its moves for the log, with elapsed milliseconds already played on it.
+void startLevel(unsigned int elapsed, bool carriedOn)
+{
+	play.levelStart = OSGetTime() - OSMillisecondsToTicks(elapsed);
+	play.moves = 0;
+	play.turns = 0;
+	play.solved = false;
+	play.carriedOn = carriedOn;
+	logLevelStart();
+}
+
+// Add the level just completed to the log of levels completed. Replays aren't logged again.
+void logCompleted()
+{
+	struct runrecord r;		// Level completed.
+
+	if (isReplaying() == true) { return; }
+	r.seed = getPlayedSeed();
+	r.level = getPlayedLevel();
+	r.mode = getPlayedMode();
+	r.gen = getPlayedGenerator();
+	r.flags = ((play.solved == true) ? RUNAUTOSOLVE : 0) | ((play.carriedOn == true) ? RUNRESUMED : 0) |
+			  ((getEndless() == true) ? RUNENDLESS : 0);
+	r.moves = play.moves;
+	r.turns = play.turns;
+	r.elapsed = (unsigned int)OSTicksToMilliseconds(OSGetTime() - play.levelStart);
+	logLevel(&r);
+}
 
 // Do game state 0 for the start screen.
 void doState0()
 {
-	VPADStatus status;			// Status returned for the gamepad button.
-	VPADReadError error;		// Error from gamepad.
+	// A replay that got to the end of the game is over once back at the start screen.
+	if (isReplaying() == true) { stopReplay(); }
 
-	VPADRead(VPAD_CHAN_0, &status, 1, &error);
-	// Check that there were no errors, before processing the button pressed.
-	if (error == VPAD_READ_SUCCESS)
+	readInput();	// Take the buttons pressed since the last frame.
+
+	// When button A press start a new level, or go back into the level carried on from the last launch. That level
+	// wasn't recorded from its start, so it isn't recorded.
+	if (getInputHeld() & VPAD_BUTTON_A)
 	{
-		// When button A press start a new level.
-		if (status.hold & VPAD_BUTTON_A)
+		if (play.resumed == true)
 		{
-			generateMaze();	// Create a random maze.
-
-			// Set the tune to match the level.
-			if (getLevel() % 2 == 1) { putsoundSel(STRTBKGND1); }
-			else { putsoundSel(STRTBKGND2); }
-			gameState = 1;	// Set state to playing.
+			startLevel(play.resumeMs, true);
+			play.resumed = false;
 		}
-		if ((status.hold & VPAD_BUTTON_ZL) && (status.hold & VPAD_BUTTON_ZR))
+		else
 		{
-			writeLevel(1);								// Set level back to 1 before starting the game.
-			OSSleepTicks(OSMillisecondsToTicks(50));	// Allow some time for file to write.
-			generateMaze();								// Create a random maze.
-			putsoundSel(STRTBKGND1);					// Start the music.
-			gameState = 1;								// Set state to playing.
+			startRecording();	// Record the game, from the settings the first maze is made with.
+			generateMaze();	// Create a random maze.
+			startLevel(0, false);
 		}
+
+		// Set the tune to match the level.
+		if (getLevel() % 2 == 1) { putsoundSel(STRTBKGND1); }
+		else { putsoundSel(STRTBKGND2); }
+		play.gameState = 1;	// Set state to playing.
+	}
+	// Changing the settings makes a new maze for the level rather than carrying on the last one.
+	if (getInputPressed() & (VPAD_BUTTON_B | VPAD_BUTTON_X | VPAD_BUTTON_Y)) { play.resumed = false; }
+
+	// B moves on to the next maze generator, including choosing it by level.
+	if (getInputPressed() & VPAD_BUTTON_B)
+	{
+		setGenerator((getGenerator() + 1) % (GENBYLEVEL + 1));
+	}
+	// X moves on to the next maze shape: normal, the long corridor that carries on south, or the open world.
+	if (getInputPressed() & VPAD_BUTTON_X)
+	{
+		setMode((getMode() + 1) % MODECOUNT);
+	}
+	// Y swaps between normal and endless mode. Re-read the level so that it is clamped or not for the new mode.
+	if (getInputPressed() & VPAD_BUTTON_Y)
+	{
+		setEndless(!getEndless());
+		readLevel();
+	}
+	// R plays back the last game recorded, through the same game states as when it was played.
+	if ((getInputPressed() & VPAD_BUTTON_R) && (startReplay() == true))
+	{
+		generateMaze();	// Create the first maze of the replay.
+		startLevel(0, false);
+		play.resumed = false;
+		if (getLevel() % 2 == 1) { putsoundSel(STRTBKGND1); }
+		else { putsoundSel(STRTBKGND2); }
+		play.gameState = 1;	// Set state to playing.
+	}
+	if ((getInputHeld() & VPAD_BUTTON_ZL) && (getInputHeld() & VPAD_BUTTON_ZR))
+	{
+		writeLevel(1);								// Set level back to 1 before starting the game, it is saved in the background.
+		startRecording();							// Record the game, from the settings the first maze is made with.
+		generateMaze();								// Create a random maze.
+		startLevel(0, false);
+		play.resumed = false;
+		putsoundSel(STRTBKGND1);					// Start the music.
+		play.gameState = 1;							// Set state to playing.
 	}
 }
 
 // Do game state 1 for playing the maze level.
 void doState1()
 {
-	VPADStatus status;			// Status returned for the gamepad button.
-	VPADReadError error;		// Error from gamepad.
-
+	struct moveevent e;			// Move pressed on the gamepad.
 	unsigned int ret;			// Return value from move player.
+	char solve = 0;				// Move auto-solve made in place of the player, 0 if none.
 
-	if (animate == 0)
+	// Take the buttons every frame, so moves pressed while the last one is animated wait to be made rather than being lost.
+	readInput();
+	if (getInputPressed() & VPAD_BUTTON_X) { play.doMap = !play.doMap; }	// Select map view.
+	if (getInputPressed() & VPAD_BUTTON_Y) { play.autoSolve = !play.autoSolve; }	// Select auto-solve.
+
+	if (play.animate == 0)
 	{
-		move = 0;
-		// Get the VPAD button last pressed.
-		VPADRead(VPAD_CHAN_0, &status, 1, &error);
-		// Check that there were no errors, before processing the button pressed.
-		if (error == VPAD_READ_SUCCESS)
+		// Make the oldest move pressed as soon as the animation has finished, or keep moving while a direction is held.
+		play.move = 0;
+		if (getMoveEvent(&e) == true) { play.move = e.move; }
+		else { play.move = getHeldMove(); }
+
+		// Auto-solve makes the moves towards the exit in place of the player, so they are animated the same way.
+		// It only knows the way in normal mazes, in the other shapes the player carries on moving themselves.
+		if (play.autoSolve == true) { solve = getSolveMove(); }
+		if (solve != 0) { play.move = solve; }
+
+		// A replay makes the recorded moves in place of the player, then goes back to the start screen at the end.
+		if ((isReplaying() == true) && (getReplayMove(&play.move) == false))
 		{
-			if ((status.hold & VPAD_BUTTON_UP) || (status.hold & VPAD_STICK_L_EMULATION_UP)) { move = 'f'; }	// Player moves.
-			if ((status.hold & VPAD_BUTTON_LEFT) || (status.hold & VPAD_STICK_L_EMULATION_LEFT)) { move = 'l'; }
-			if ((status.hold & VPAD_BUTTON_RIGHT) || (status.hold & VPAD_STICK_L_EMULATION_RIGHT)) { move = 'r'; }
-
-			if (status.trigger & VPAD_BUTTON_X) { doMap = !doMap; }	// Select map view.
+			stopReplay();
+			clearInput();
+			play.gameState = 0;
+			play.colour = 0;
+			return;
 		}
 
-		ret = movePlayer(move);		// Send the move the game and check the response to the move.
+		ret = movePlayer(play.move);		// Send the move the game and check the response to the move.
+		recordMove(play.move, ret);			// Record every frame that reads input, so the replay keeps in step.
+
+		// Count the moves made for the log of levels completed.
+		if ((ret != 0) && (play.move == 'f')) { play.moves++; }
+		if ((ret != 0) && ((play.move == 'l') || (play.move == 'r'))) { play.turns++; }
+		if ((ret != 0) && (solve != 0)) { play.solved = true; }
 
 		if (ret == 1)		// If move was a valid move start the animation.
 		{
-			animate = 1;
+			play.animate = 1;
 		}
 		else if (ret == 2)	// If the move reached the exit, go to the new level state or end if reached the top level.
 		{
-			// If at the end go to end state, otherwise go to next level.
-			if (getLevel() >= MAXLEVEL) { gameState = 3; colour = 0;  } // Set colour to 0 to fade text in.
-			else { gameState = 2; }
+			clearInput();	// Moves pressed for this level aren't made in the next.
+			logCompleted();	// Keep how the level was played.
+
+			// If at the end go to end state, otherwise go to next level. Endless mode never ends.
+			if ((getEndless() == false) && (getLevel() >= MAXLEVEL)) { play.gameState = 3; play.colour = 0;  } // Set colour to 0 to fade text in.
+			else { play.gameState = 2; play.levelTime = OSGetTime(); }
 		}
 	}
 	else // If we are animating increment the animation count for the next step.
 	{
-		animate++;
-		if (animate == 5) { animate = 0; }	// Set back to 0 at the end of animation.
+		play.animate++;
+		if (play.animate == 5) { play.animate = 0; }	// Set back to 0 at the end of animation.
 	}
 }
 
 // Do game state 2 for the new level screen.
 void doState2()
 {
-	OSSleepTicks(OSMillisecondsToTicks(3000));		// Allow some time to be seen and heard.
-	generateMaze();		// Create a new maze (slightly bigger for each level).
+	// Buttons pressed on the new level screen aren't moves in the new level.
+	readInput();
+	clearInput();
+
+	// Allow some time to be seen and heard, carrying on round the main loop rather than sleeping.
+	if (OSTicksToMilliseconds(OSGetTime() - play.levelTime) < 3000) { return; }
+	generateMaze();		// Swap in the new maze (slightly bigger for each level), made while the last level was played.
+	startLevel(0, false);
 
 	// Alternate the background music for each level.
 	if (getLevel() % 2 == 1) { putsoundSel(STRTBKGND1); }
 	else { putsoundSel(STRTBKGND2); }
 
-	gameState = 1;	// Go back to the playing state.
+	play.gameState = 1;	// Go back to the playing state.
 }
 
 // Do game state 3 for the end of game screen.
 void doState3()
 {
-	VPADStatus status;			// Status returned for the gamepad button.
-	VPADReadError error;		// Error from gamepad.
+	readInput();	// Take the buttons pressed since the last frame.
+	if (getInputHeld() & VPAD_BUTTON_B) { play.gameState = 0; play.colour = 0; }  // Set colour to 0 to fade text in and go back to the start.
+}
+
+// Save the level being played when the game goes to the background or exits, so that the next launch carries on from
+// where the player was. Anything else (the start screen, a replay, between levels) removes the old snapshot instead.
+void suspendPlay()
+{
+	unsigned int elapsed = play.resumeMs;	// Time played on the level in milliseconds.
+
+	if (play.gameState == 1) { elapsed = (unsigned int)OSTicksToMilliseconds(OSGetTime() - play.levelStart); }
+	if ((isReplaying() == false) && ((play.gameState == 1) || (play.resumed == true))) { saveSnapshot(NULL, elapsed); }
+	else { clearSnapshot(NULL); }
+}
 
-	VPADRead(VPAD_CHAN_0, &status, 1, &error);
-	// Check that there were no errors, before processing the button pressed.
-	if (error == VPAD_READ_SUCCESS)
+// Carry on the level saved by suspendPlay, call at launch once the settings are set. The maze is put back as it was
+// rather than made again, and pressing A on the start screen goes straight back into it.
+void resumePlay()
+{
+	unsigned int elapsed;	// Time played on the level in milliseconds.
+
+	if (loadSnapshot(NULL, &elapsed) == true)
 	{
-		if (status.hold & VPAD_BUTTON_B) { gameState = 0; colour = 0; }  // Set colour to 0 to fade text in and go back to the start.
+		play.resumed = true;
+		play.resumeMs = elapsed;
 	}
 }
 
+#ifdef __WIIU__
+// Called when the game goes to the background for the HOME menu or to close, save the level being played and anything
+// queued to be saved.
+static uint32_t releaseCallback(void* context)
+{
+	play.pausedAt = OSGetTime();
+	suspendPlay();
+	storageFlush();		// The game may be closed from the HOME menu, so write out the files queued.
+	return 0;
+}
+
+// Called when the game comes back from the background, the time away isn't time played on the level.
+static uint32_t acquireCallback(void* context)
+{
+	play.levelStart += OSGetTime() - play.pausedAt;
+	return 0;
+}
+
 // This is the main process and must be in the program at the start for the home button to operate correctly.
 int main(int argc, char **argv) 
 {
     WHBProcInit();
     WHBLogConsoleInit();	// Console Init seem to get the display to operate correctly so keep in the build.
 
+	startStorage(STORAGESD);	// Keep the game's files on the SD card, finding the game's directory once.
+	startRunLog();			// Load the best time for each level from the index of the log.
 	setupSound();
+	startInput();			// Poll the gamepad on its own thread, so input doesn't wait on drawing the displays.
 
 	readLevel();			// Get the level from the data file so that it is correct for the first screen.
+	openPack(NULL);			// Play levels from levels.lab if it has been installed, otherwise they are generated.
+	setCandidates(3);		// Pick each maze from three candidates, made at the same time on the three cores.
+	setSeed((unsigned int)OSGetTime());	// Seed the first maze from the time, after that each maze seed follows from the last.
+	resumePlay();			// Carry on the level being played when the game was last closed, if there was one.
+
+	// Save the level being played whenever the game goes to the background, it may not come back.
+	ProcUIRegisterCallback(PROCUI_CALLBACK_RELEASE, releaseCallback, NULL, 100);
+	ProcUIRegisterCallback(PROCUI_CALLBACK_ACQUIRE, acquireCallback, NULL, 100);
 
 	// There must be a main loop on WHBProc running, for the program to correctly operate with the home button.
 	// Home pauses this loop and continues it if resume is selected. There must therefore be one main loop of processing in the main program.
     while (WHBProcIsRunning()) 
 	{
-		switch (gameState)
+		OSTime frameStart = OSGetTime();	// Time the frame started, to log how long frames take to run.
+
+		switch (play.gameState)
 		{
 			case 0:	// Start Screen.
 			{
@@ -411,13 +627,21 @@ int main(int argc, char **argv)
 		}
 
 		displays();	// Update the displays.
+		logFrame((unsigned int)OSTicksToMicroseconds(OSGetTime() - frameStart));
 		OSSleepTicks(OSMillisecondsToTicks(30));		// Allow some time for moves to be seen.
     }
 
+	stopRecording();		// Keep the moves made since the last level was completed.
+	suspendPlay();			// Keep the level being played to carry on next time.
+	stopReplay();			// Put back the player's own level if a replay was stopped part way.
+	stopMaze();				// Let any maze being made in the background finish.
+	stopInput();			// Stop polling the gamepad.
+	closePack();			// Free the pack of mazes.
 	QuitSound();
 
 	// If we get out of the program clean up and exit.
     WHBLogConsoleFree();
     WHBProcShutdown();
     return 0;
-}
\ No newline at end of file
+}
+#endif
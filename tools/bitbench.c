@@ -0,0 +1,195 @@
+// Benchmark of the Bitboard kernels for a Linux PC. Makes one large maze, then times a flood fill and counting dead ends
+// and junctions, once on a character for each cell as the game used to hold the maze, and once with the Bitboard kernels
+// working on 64 cells at a time. Both must get the same answers.
+//
+// Build from the top of the repository with:
+//   gcc -O2 -pthread -I source -o bitbench tools/bitbench.c source/Labyrinth.c source/Threads.c source/Bitboard.c source/Storage.c
+//
+// Usage: bitbench [-l level] [-g generator] [-S seed] [-t times]
+//   -l  Level to make the maze for (default 329, a maze of 1001 x 1001 cells).
+//   -g  Generator from enum MAZEGEN, 0 to 4 (default 1, the recursive backtracker).
+//   -S  Seed for the maze (default 1).
+//   -t  Number of times to run each test, the best time is shown (default 20).
+
+#include <stdio.h>				// For printing.
+#include <stdlib.h>				// For atoi and memory.
+#include <stdint.h>				// For exact sized integers.
+#include <stdbool.h>			// For booleans.
+#include <string.h>				// For memset.
+#include <time.h>				// For timing.
+#include <unistd.h>				// For getopt.
+
+#include "Labyrinth.h"			// For making mazes.
+#include "Sounds.h"				// For the sound stub.
+#include "Bitboard.h"			// For the kernels being measured.
+
+// The game plays sounds when the player moves, but no sound is needed here.
+void putsoundSel(soundsel_t sndSel)
+{
+}
+
+// Get a time in milliseconds.
+static double nowMs(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (t.tv_sec * 1000.0) + (t.tv_nsec / 1000000.0);
+}
+
+// Flood fill from x, y on a character grid, a cell at a time. seen and queue must have room for every cell.
+// Returns the number of spaces reached.
+static unsigned int charFloodFill(const char* grid, unsigned int size, unsigned int x, unsigned int y, unsigned char* seen, unsigned int* queue)
+{
+	unsigned int head = 0, tail = 0;	// Queue positions.
+	unsigned int c, n;					// Cell and next cell.
+	const int step[4] = { -(int)size, 1, (int)size, -1 };
+
+	memset(seen, 0, (size_t)size * size);
+	c = (y * size) + x;
+	if (grid[c] != ' ') { return 0; }
+	seen[c] = 1;
+	queue[tail++] = c;
+
+	while (head < tail)
+	{
+		c = queue[head++];
+		for (unsigned int d = 0; d < 4; d++)
+		{
+			n = c + step[d];
+			if ((grid[n] == ' ') && (seen[n] == 0))
+			{
+				seen[n] = 1;
+				queue[tail++] = n;
+			}
+		}
+	}
+	return tail;
+}
+
+// Count the spaces, dead ends and junctions on a character grid, a cell at a time. The outer wall means the cells next to
+// a space are always in the grid. Returns the number of spaces.
+static unsigned int charCountWays(const char* grid, unsigned int size, unsigned int* deadEnds, unsigned int* junctions)
+{
+	unsigned int spaces = 0, ends = 0, joins = 0, ways;
+
+	for (unsigned int y = 1; y < size - 1; y++)
+	{
+		for (unsigned int x = 1; x < size - 1; x++)
+		{
+			if (grid[(y * size) + x] != ' ') { continue; }
+			spaces++;
+			ways = (grid[((y - 1) * size) + x] == ' ') + (grid[((y + 1) * size) + x] == ' ') +
+				   (grid[(y * size) + x - 1] == ' ') + (grid[(y * size) + x + 1] == ' ');
+			if (ways == 1) { ends++; }
+			if (ways >= 3) { joins++; }
+		}
+	}
+	*deadEnds = ends;
+	*junctions = joins;
+	return spaces;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int level = 329;			// Level the maze is for.
+	mazegen_t gen = GENBACKTRACK;		// Generator used.
+	uint32_t seed = 1;					// Seed for the maze.
+	unsigned int times = 20;			// Times to run each test.
+	struct maze* m;						// The maze.
+	struct bitgrid g;					// The maze as bits.
+	unsigned int size, sx, sy;			// Cells along each side and the start.
+	char* grid;							// The maze as a character for each cell.
+	unsigned char* seen;				// Cells reached by the character flood fill.
+	unsigned int* queue;				// Queue for the character flood fill.
+	uint64_t* reached;					// Cells reached by the Bitboard flood fill.
+	unsigned int* work;					// Working memory for the Bitboard flood fill.
+	unsigned int charFill = 0, bitFill = 0;				// Spaces reached.
+	unsigned int charSpaces = 0, bitSpaces = 0;			// Spaces counted.
+	unsigned int charEnds, charJoins, bitEnds, bitJoins;	// Dead ends and junctions counted.
+	double charFillMs = 1e9, bitFillMs = 1e9, charWaysMs = 1e9, bitWaysMs = 1e9;	// Best times.
+	double start, took;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "l:g:S:t:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'l': { level = (unsigned int)atoi(optarg); break; }
+			case 'g': { gen = (mazegen_t)atoi(optarg); break; }
+			case 'S': { seed = (uint32_t)strtoul(optarg, NULL, 0); break; }
+			case 't': { times = (unsigned int)atoi(optarg); break; }
+			default:
+			{
+				fprintf(stderr, "Usage: %s [-l level] [-g generator] [-S seed] [-t times]\n", argv[0]);
+				return 1;
+			}
+		}
+	}
+	if ((level < 1) || (gen >= GENCOUNT) || (times < 1)) { fprintf(stderr, "Bad level, generator or times\n"); return 1; }
+
+	m = newMaze();
+	if (m == NULL) { fprintf(stderr, "Out of memory\n"); return 1; }
+	makeMaze(m, level, seed, gen);
+	size = getMazeSize(m);
+	getMazeStart(m, &sx, &sy);
+	getMazeGrid(m, &g);
+
+	grid = malloc((size_t)size * size);
+	seen = malloc((size_t)size * size);
+	queue = malloc((size_t)size * size * sizeof(unsigned int));
+	reached = malloc((size_t)size * BITWORDS(size) * sizeof(uint64_t));
+	work = malloc((size_t)size * BITWORDS(size) * 2 * sizeof(unsigned int));
+	if ((grid == NULL) || (seen == NULL) || (queue == NULL) || (reached == NULL) || (work == NULL))
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	// The exit is a space in the grid of bits, so it is here too.
+	for (unsigned int y = 0; y < size; y++)
+	{
+		for (unsigned int x = 0; x < size; x++) { grid[(y * size) + x] = (getMazeCell(m, x, y) == '#') ? '#' : ' '; }
+	}
+
+	for (unsigned int i = 0; i < times; i++)
+	{
+		start = nowMs();
+		charFill = charFloodFill(grid, size, sx, sy, seen, queue);
+		took = nowMs() - start;
+		if (took < charFillMs) { charFillMs = took; }
+
+		start = nowMs();
+		bitFill = bitFloodFill(&g, sx, sy, reached, work);
+		took = nowMs() - start;
+		if (took < bitFillMs) { bitFillMs = took; }
+
+		start = nowMs();
+		charSpaces = charCountWays(grid, size, &charEnds, &charJoins);
+		took = nowMs() - start;
+		if (took < charWaysMs) { charWaysMs = took; }
+
+		start = nowMs();
+		bitSpaces = bitCountWays(&g, &bitEnds, &bitJoins);
+		took = nowMs() - start;
+		if (took < bitWaysMs) { bitWaysMs = took; }
+	}
+
+	printf("%s maze, %u x %u cells, %u spaces, best of %u\n", getGeneratorName(gen), size, size, charSpaces, times);
+	printf("flood fill:  char %8.3f ms  bits %8.3f ms  %5.1fx  (%u / %u reached)\n",
+		charFillMs, bitFillMs, charFillMs / bitFillMs, charFill, bitFill);
+	printf("count ways:  char %8.3f ms  bits %8.3f ms  %5.1fx  (%u / %u dead ends, %u / %u junctions)\n",
+		charWaysMs, bitWaysMs, charWaysMs / bitWaysMs, charEnds, bitEnds, charJoins, bitJoins);
+
+	if ((charFill != bitFill) || (charSpaces != bitSpaces) || (charEnds != bitEnds) || (charJoins != bitJoins))
+	{
+		printf("Bitboard results differ\n");
+		return 1;
+	}
+	free(grid);
+	free(seen);
+	free(queue);
+	free(reached);
+	free(work);
+	freeMaze(m);
+	return 0;
+}
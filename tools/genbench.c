@@ -0,0 +1,210 @@
+// Generator benchmark for a Linux PC. Makes the same mazes with each generator in turn on one thread, and reports for
+// each generator the cells made each second, the most memory it used, and the measures of the mazes it made, so the
+// generators can be compared for speed, memory and the kind of maze they make.
+//
+// With -c it also times the game picking each maze from 1 up to that many candidates, and reports how near the mazes
+// kept come to the difficulty wanted for the level, so the cost of more candidates can be weighed against what they do.
+//
+// Build from the top of the repository with:
+//   gcc -O2 -pthread -I source -o genbench tools/genbench.c source/Labyrinth.c source/Threads.c source/Bitboard.c source/Storage.c -lm
+//
+// Usage: genbench [-n count] [-l level] [-g generator] [-S seed] [-c candidates]
+//   -n  Number of mazes made with each generator (default 20).
+//   -l  Level to make the mazes for, higher levels make larger mazes (default 300).
+//   -g  Only time this generator from enum MAZEGEN, 0 to 4 (default all of them).
+//   -S  Seed for the first maze, maze i is made from seed + i (default 1). Every generator makes mazes from the same seeds.
+//   -c  Also time the game making mazes from 1 up to this many candidates, 1 to MAXCANDIDATES (default 0, not timed).
+//       These use the generator given with -g, or take turns through them by level as the game does.
+
+#include <stdio.h>				// For printing.
+#include <stdlib.h>				// For atoi.
+#include <stdint.h>				// For exact sized integers.
+#include <stdbool.h>			// For booleans.
+#include <math.h>				// For the square root.
+#include <time.h>				// For timing.
+#include <unistd.h>				// For getopt.
+
+#include "Labyrinth.h"			// For making mazes.
+#include "Sounds.h"				// For the sound stub.
+#include "Storage.h"			// For keeping the level file in memory.
+#include "Threads.h"			// For the number of cores.
+
+// Totals for one generator.
+struct bench
+{
+	double ms;					// Time to make every maze in milliseconds.
+	double bestMs;				// Fastest maze.
+	double cells;				// Cells in every maze.
+	size_t mazeBytes;			// Most memory used while making a maze.
+	size_t genBytes;			// Most working memory the generator used on top of the maze array.
+	double path;				// Sum of the moves from the start to the exit.
+	double winding;				// Sum of the path divided by the cells along each side.
+	double deadEnds;			// Sum of the dead ends in each 100 spaces.
+	double junctions;			// Sum of the junctions in each 100 spaces.
+	double corridor;			// Sum of the average corridor lengths.
+	double branching;			// Sum of the average ways on from a junction.
+	unsigned int repairs;		// Walls opened to join parts of the mazes.
+};
+
+// The game plays sounds when the player moves, but no sound is needed here.
+void putsoundSel(soundsel_t sndSel)
+{
+}
+
+// Get a time in milliseconds.
+static double nowMs(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (t.tv_sec * 1000.0) + (t.tv_nsec / 1000000.0);
+}
+
+// Make every maze with one generator, adding up the time, memory and measures.
+static void benchGenerator(struct maze* m, mazegen_t gen, unsigned int count, unsigned int level, uint32_t seed,
+	struct bench* b)
+{
+	struct mazestats stats;		// Measures of each maze.
+	unsigned int size;			// Cells along each side.
+	double start, ms;			// Time the maze was started and taken.
+
+	b->bestMs = 0.0;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		start = nowMs();
+		makeMaze(m, level, seed + i, gen);
+		ms = nowMs() - start;
+		b->ms += ms;
+		if ((i == 0) || (ms < b->bestMs)) { b->bestMs = ms; }
+
+		size = getMazeSize(m);
+		b->cells += (double)size * size;
+		if (getMazeBytes(m) > b->mazeBytes) { b->mazeBytes = getMazeBytes(m); }
+		if (getGeneratorBytes(m) > b->genBytes) { b->genBytes = getGeneratorBytes(m); }
+
+		getMazeStats(m, &stats);
+		b->path += stats.path;
+		b->winding += (double)stats.path / size;
+		if (stats.spaces != 0)
+		{
+			b->deadEnds += 100.0 * stats.deadEnds / stats.spaces;
+			b->junctions += 100.0 * stats.junctions / stats.spaces;
+		}
+		b->corridor += stats.corridor;
+		b->branching += stats.branching;
+		b->repairs += stats.repairs;
+	}
+}
+
+// Time the game making the same mazes from 1 up to most candidates each, and print how near the mazes kept come to the
+// difficulty wanted. size is the cells along each side of the mazes for the level.
+static void benchCandidates(unsigned int most, mazegen_t gen, unsigned int count, unsigned int level, uint32_t seed,
+	unsigned int size)
+{
+	struct game* g = newGame();	// Game making the mazes.
+	struct mazestats stats;		// Measures of each maze kept.
+	float target = getMazeTarget(level);	// Difficulty wanted.
+	double ms, start;			// Time for every maze and when the maze was started.
+	double sum, squares, miss;	// Sums of the difficulty, its squares and how far it is from the target.
+	double mean;				// Average difficulty.
+
+	if (g == NULL) { fprintf(stderr, "Out of memory\n"); return; }
+	gameSetGenerator(g, gen);
+	gameSetEndless(g, true);	// So levels past MAXLEVEL make larger mazes, as makeMaze does.
+	printf("\nCandidates for level %u on %u cores, difficulty is path/side and the target is %.2f\n", level, threadCores(),
+		target);
+	printf("%-10s %9s %9s %9s %9s\n", "candidates", "ms/maze", "mean", "std dev", "mean miss");
+
+	for (unsigned int k = 1; k <= most; k++)
+	{
+		gameSetCandidates(g, k);
+		ms = sum = squares = miss = 0.0;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			// The level is set back each time, so the maze made ahead for the next level is never used, and this waits
+			// for it to be finished so only the maze being timed is being made.
+			gameWriteLevel(g, level);
+			gameSetSeed(g, seed + i);
+			gameStopMaze(g);
+			start = nowMs();
+			gameGenerateMaze(g);
+			ms += nowMs() - start;
+
+			gameGetStats(g, &stats);
+			sum += (double)stats.path / size;
+			squares += ((double)stats.path / size) * ((double)stats.path / size);
+			miss += fabs(((double)stats.path / size) - target);
+		}
+		mean = sum / count;
+		printf("%-10u %9.2f %9.2f %9.2f %9.2f\n", k, ms / count, mean, sqrt(fmax((squares / count) - (mean * mean), 0.0)),
+			miss / count);
+	}
+	freeGame(g);
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int count = 20;			// Mazes made with each generator.
+	unsigned int level = 300;			// Level the mazes are for.
+	int only = -1;						// Only generator timed, -1 for all of them.
+	uint32_t seed = 1;					// Seed of the first maze.
+	unsigned int candidates = 0;		// Most candidates timed, 0 for none.
+	struct maze* m;						// Maze re-used for every maze made.
+	struct bench b;						// Totals for the generator being timed.
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:l:g:S:c:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n': { count = (unsigned int)atoi(optarg); break; }
+			case 'l': { level = (unsigned int)atoi(optarg); break; }
+			case 'g': { only = atoi(optarg); break; }
+			case 'S': { seed = (uint32_t)strtoul(optarg, NULL, 0); break; }
+			case 'c': { candidates = (unsigned int)atoi(optarg); break; }
+			default:
+			{
+				fprintf(stderr, "Usage: %s [-n count] [-l level] [-g generator] [-S seed] [-c candidates]\n", argv[0]);
+				return 2;
+			}
+		}
+	}
+	if ((count < 1) || (level < 1) || (only >= GENCOUNT) || (candidates > MAXCANDIDATES))
+	{
+		fprintf(stderr, "Bad count, level, generator or candidates\n");
+		return 2;
+	}
+
+	m = newMaze();
+	if (m == NULL) { fprintf(stderr, "Out of memory\n"); return 1; }
+
+	// Make one maze first so the arena is already as large as it needs to be for every generator.
+	makeMaze(m, level, seed, GENBLOCKS);
+	printf("%u mazes of %u x %u cells for level %u with each generator\n\n", count, getMazeSize(m), getMazeSize(m), level);
+	printf("%-14s %10s %9s %9s %9s %9s %7s %9s %9s %8s %9s %7s\n", "generator", "Mcells/s", "ms/maze", "best ms",
+		"peak KB", "work KB", "path", "path/side", "deadend%", "junct%", "corridor", "branch");
+
+	for (int gen = 0; gen < GENCOUNT; gen++)
+	{
+		if ((only >= 0) && (gen != only)) { continue; }
+		b = (struct bench){ 0 };
+		benchGenerator(m, (mazegen_t)gen, count, level, seed, &b);
+		printf("%-14s %10.2f %9.2f %9.2f %9zu %9zu %7.0f %9.2f %9.2f %8.2f %9.2f %7.2f", getGeneratorName((mazegen_t)gen),
+			(b.ms > 0.0) ? b.cells / (b.ms * 1000.0) : 0.0, b.ms / count, b.bestMs, b.mazeBytes / 1024,
+			b.genBytes / 1024, b.path / count, b.winding / count, b.deadEnds / count, b.junctions / count,
+			b.corridor / count, b.branching / count);
+		if (b.repairs != 0) { printf("  %u repairs", b.repairs); }
+		printf("\n");
+	}
+
+	printf("\npeak KB is the most memory used making a maze, the maze array and any working memory, and work KB is the\n");
+	printf("most working memory the generator itself used on top of the maze array.\n");
+
+	if (candidates > 0)
+	{
+		startStorage(STORAGEMEMORY);	// The game saves the level with each maze, keep it off the disk.
+		benchCandidates(candidates, (only >= 0) ? (mazegen_t)only : GENBYLEVEL, count, level, seed, getMazeSize(m));
+	}
+	freeMaze(m);
+	return 0;
+}
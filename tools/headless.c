@@ -0,0 +1,546 @@
+// Headless run of the game for a Linux PC. The game states from main.c are run as fast as they will go, with no
+// display and no waiting, and the gamepad comes from a script or from a solver that plays the game. Reports how fast the
+// game runs and the time taken in each game state, so the game can be soak tested and profiled apart from the graphics.
+// The solver presses a button for one move at a time and waits for the player to move before pressing the next, so it
+// plays like a player would. It exits with 1 if no level was completed, or a replay didn't complete the levels it did
+// when it was recorded, so a broken maze shape or solver shows up in scripts.
+//
+// Build from the top of the repository with:
+//   gcc -O2 -pthread -I source -o headless tools/headless.c source/main.c source/Input.c source/Replay.c source/Labyrinth.c source/Threads.c source/Bitboard.c source/Storage.c source/RunLog.c
+//
+// Usage: headless [-t ticks] [-s script] [-l level] [-g generator] [-m mode] [-S seed] [-c candidates] [-e] [-d dir | -M]
+//                 [-k] [-w replay | -r replay]
+//   -t  Number of ticks (times round the main loop) to run (default 100000).
+//   -s  Script of gamepad input to play, the solver carries on when it runs out. Each line is a number of ticks then
+//       the buttons held for them, from A B X Y R UP DOWN LEFT RIGHT ZL ZR, eg "5 UP" or "1 A". # starts a comment.
+//   -l  Level to start from (default 1).
+//   -g  Generator from enum MAZEGEN, 0 to 4, or 5 to choose from the level (default 5).
+//   -m  Maze shape from enum MAZEMODE, 0 to 2 (default 0).
+//   -S  Seed for the first maze (default 1).
+//   -c  Candidates each maze is picked from (default 1).
+//   -e  Play in endless mode, so levels carry on past MAXLEVEL.
+//   -d  Directory the level file is kept in, under wiiu/apps/Labyrinth as on the Wii U (default a new temporary one).
+//   -M  Keep the level file in memory rather than on the disk, so no time is spent on files. Can't be used with -d, -k,
+//       -w or -r, which are about files on the disk.
+//   -k  Keep the level being played between runs, as the game does when it is closed. The run carries on from
+//       resume.bin if it is there (the level file keeps its level, -l is not used), and saves it again at the end.
+//   -w  Write the recording of the game to this replay file, as the game does to replay.lrp.
+//   -r  Play this replay file instead, the same way as pressing R on the start screen, and stop at the end of it.
+
+#include <stdio.h>				// For printing and files.
+#include <stdlib.h>				// For atoi and memory.
+#include <stdint.h>				// For exact sized integers.
+#include <stdbool.h>			// For booleans.
+#include <string.h>				// For strings.
+#include <time.h>				// For timing.
+#include <unistd.h>				// For getopt and the working directory.
+#include <sys/stat.h>			// For mkdir.
+
+#include "Headless.h"			// For the game states and the stand-in gamepad and clock.
+#include "Labyrinth.h"			// For the game settings and the solver.
+#include "Sounds.h"				// For the sound stub.
+#include "Replay.h"				// For the replay file.
+#include "Storage.h"			// For keeping the files in memory.
+#include "RunLog.h"				// For the log of levels completed.
+
+#define FRAMEMS    30			// Game time for each tick, the same as the main loop on the Wii U.
+#define MAXSTEPS   100000		// Most lines in a script.
+#define STATES     4			// Game states, 0 start, 1 playing, 2 new level, 3 end.
+#define SOLVEWAIT  50			// Ticks the solver waits for its move to be made before deciding again, longer than any animation.
+#define PLANRANGE  1024			// Cells each way from the player searched for the exit of an open world.
+#define PLANSIDE   (PLANRANGE * 2)	// Cells along each side of the search area.
+#define PLANTILE   32			// Cells along each side of the tiles of the search area read from the game at once.
+#define PLANTILES  (PLANSIDE / PLANTILE)	// Tiles along each side of the search area.
+
+// One line of a script, buttons held for a number of ticks.
+struct step
+{
+	unsigned int ticks;			// Ticks the buttons are held for.
+	uint32_t buttons;			// Buttons held.
+};
+
+// Names of the buttons a script can use.
+static const struct
+{
+	const char* name;
+	uint32_t button;
+} buttonNames[] =
+{
+	{ "A", VPAD_BUTTON_A }, { "B", VPAD_BUTTON_B }, { "X", VPAD_BUTTON_X }, { "Y", VPAD_BUTTON_Y }, { "R", VPAD_BUTTON_R },
+	{ "UP", VPAD_BUTTON_UP }, { "DOWN", VPAD_BUTTON_DOWN }, { "LEFT", VPAD_BUTTON_LEFT }, { "RIGHT", VPAD_BUTTON_RIGHT },
+	{ "ZL", VPAD_BUTTON_ZL }, { "ZR", VPAD_BUTTON_ZR },
+};
+
+static struct step* script = NULL;	// Script being played.
+static unsigned int scriptSteps = 0;	// Lines in the script.
+static unsigned int scriptStep = 0;		// Line being played.
+static unsigned int stepTicks = 0;		// Ticks played of the line.
+static uint32_t lastHold = 0;			// Buttons held at the last read, to work out which are newly pressed.
+static bool replay = false;				// Set to play a replay rather than solve the mazes.
+static uint32_t padHold = 0;			// Buttons held this tick, worked out before the game state is run and timed.
+
+// The solver, which makes a move then waits for the player's position to change before deciding on the next.
+static bool turnedLeft = false;			// Set when the solver's last move was a left turn to follow the left wall.
+static unsigned int solveX, solveY, solveD;	// Where the player was when the solver made its last move.
+static unsigned int solveWait = 0;		// Ticks the solver has waited for its last move, 0 when it is ready for the next.
+
+// The way to the exit of an open world, found with a search out from the player. The area searched is read from
+// get2DView a tile at a time as the search reaches it. Cells and tiles are only used when their stamp is the current
+// search, so nothing needs clearing between searches.
+static char* area;						// Cells of the area, the player is at PLANRANGE, PLANRANGE.
+static unsigned int* tileStamp;			// Search each tile was last read for.
+static unsigned int* cellStamp;			// Search each cell was last reached in.
+static unsigned char* cellFrom;			// Direction the search reached each cell from.
+static unsigned int* queue;				// Search queue, the end of it holds the way found.
+static unsigned int stamp = 0;			// Current search.
+static unsigned int planSteps = 0;		// Directions left in the way to the exit, at the end of the queue.
+static unsigned int planX, planY;		// Cell the player should be in to take the next step.
+static bool planTried = false;			// Set once the exit has been searched for on this level.
+static OSTime clockTicks = 0;			// Game time, moved on a frame each tick.
+
+// The game plays sounds, but no sound is needed here.
+void putsoundSel(soundsel_t sndSel)
+{
+}
+
+// Stand-in for the Wii U clock, game time moves on a frame each tick however fast the ticks are run.
+OSTime OSGetTime(void)
+{
+	return clockTicks;
+}
+
+// Get a time in milliseconds.
+static double nowMs(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (t.tv_sec * 1000.0) + (t.tv_nsec / 1000000.0);
+}
+
+// Get a cell of the search area, reading its tile from the game the first time it is needed in a search.
+static char areaCell(unsigned int x, unsigned int y)
+{
+	unsigned int tile = ((y / PLANTILE) * PLANTILES) + (x / PLANTILE);	// Tile the cell is in.
+	unsigned int tx = x - (x % PLANTILE), ty = y - (y % PLANTILE);		// Top left of the tile.
+
+	if (tileStamp[tile] != stamp)
+	{
+		for (unsigned int j = 0; j < PLANTILE; j++)
+		{
+			for (unsigned int i = 0; i < PLANTILE; i++)
+			{
+				area[((ty + j) * PLANSIDE) + tx + i] = get2DView((int)(tx + i) - PLANRANGE, (int)(ty + j) - PLANRANGE);
+			}
+		}
+		tileStamp[tile] = stamp;
+	}
+	return area[(y * PLANSIDE) + x];
+}
+
+// Search out from the player for the exit of an open world, and keep the way to it for planMove.
+// Returns false if the exit isn't within PLANRANGE cells of the player or there isn't the memory to search.
+static bool planExit(void)
+{
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for each direction.
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+	unsigned int start = (PLANRANGE * PLANSIDE) + PLANRANGE;	// Cell the player is in.
+	unsigned int head = 0, tail = 0;	// Queue positions.
+	unsigned int c, n, x, y;			// Cell, next cell and its position.
+	char cell;							// Next cell in the maze.
+
+	planSteps = 0;
+	if (area == NULL)
+	{
+		area = malloc((size_t)PLANSIDE * PLANSIDE);
+		cellFrom = malloc((size_t)PLANSIDE * PLANSIDE);
+		cellStamp = calloc((size_t)PLANSIDE * PLANSIDE, sizeof(unsigned int));
+		queue = malloc((size_t)PLANSIDE * PLANSIDE * sizeof(unsigned int));
+		tileStamp = calloc((size_t)PLANTILES * PLANTILES, sizeof(unsigned int));
+	}
+	if ((area == NULL) || (cellFrom == NULL) || (cellStamp == NULL) || (queue == NULL) || (tileStamp == NULL)) { return false; }
+	stamp++;
+
+	cellStamp[start] = stamp;
+	queue[tail++] = start;
+	while (head < tail)
+	{
+		c = queue[head++];
+		for (unsigned int d = 1; d <= 4; d++)
+		{
+			x = (c % PLANSIDE) + dx[d];
+			y = (c / PLANSIDE) + dy[d];
+			if ((x >= PLANSIDE) || (y >= PLANSIDE)) { continue; }
+			n = (y * PLANSIDE) + x;
+			if (cellStamp[n] == stamp) { continue; }
+			cell = areaCell(x, y);
+			if ((cell != ' ') && (cell != 'E')) { continue; }
+			cellStamp[n] = stamp;
+			cellFrom[n] = (unsigned char)d;
+			if (cell != 'E') { queue[tail++] = n; continue; }
+
+			// Follow the way back to the player, keeping the directions at the end of the queue, which isn't needed now.
+			while (n != start)
+			{
+				d = cellFrom[n];
+				queue[(PLANSIDE * PLANSIDE) - 1 - planSteps++] = d;
+				n = (unsigned int)((int)n - dx[d] - (dy[d] * PLANSIDE));
+			}
+			getPlayerPosition(&planX, &planY, NULL);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Get the move along the way to the exit found by planExit, for a player at x, y facing d. Returns 0 if there is no
+// way, or the player isn't where the way goes.
+static char planMove(unsigned int x, unsigned int y, unsigned int d)
+{
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for each direction.
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+	unsigned int want;		// Direction of the next step.
+
+	if ((planSteps == 0) || (x != planX) || (y != planY)) { return 0; }
+	want = queue[(PLANSIDE * PLANSIDE) - planSteps];
+	if (want == d)
+	{
+		planSteps--;
+		planX += dx[want];
+		planY += dy[want];
+		return 'f';
+	}
+	return (((d % 4) + 1) == want) ? 'r' : 'l';
+}
+
+// Get the next move for the solver. Walk the player to the exit when the game knows the way, or along the way found
+// to the exit of an open world, otherwise follow the left hand wall.
+static char solverMove(unsigned int x, unsigned int y, unsigned int d)
+{
+	char move = getSolveMove();		// Move towards the exit.
+
+	if ((move == 0) && (getMode() == MODEWORLD))
+	{
+		move = planMove(x, y, d);
+		if ((move == 0) && (planTried == false))
+		{
+			planTried = true;
+			if (planExit() == true) { move = planMove(x, y, d); }
+		}
+	}
+	if (move == 0)
+	{
+		if ((turnedLeft == true) && (get3DView(1, 0) != '#')) { move = 'f'; }
+		else if (get3DView(0, -1) != '#') { move = 'l'; }
+		else if (get3DView(1, 0) != '#') { move = 'f'; }
+		else { move = 'r'; }
+	}
+	turnedLeft = (move == 'l');
+	return move;
+}
+
+// Get the buttons the solver holds to play the game. Press A to start, then press the button for each move for one
+// tick, waiting for the player to move before deciding on the next, and press B at the end to go back to the start.
+// To play a replay press R to start it, the replay then makes the moves.
+static uint32_t solverButtons(void)
+{
+	unsigned int x, y, d;	// Where the player is.
+	char move;				// Move made.
+
+	if (getGameState() != 1)
+	{
+		// Between levels, so the way to the last exit is no use and the solver is ready for the first move.
+		solveWait = 0;
+		planSteps = 0;
+		planTried = false;
+		turnedLeft = false;
+		switch (getGameState())
+		{
+			case 0: { return (replay == true) ? VPAD_BUTTON_R : VPAD_BUTTON_A; }
+			case 3: { return VPAD_BUTTON_B; }
+			default: { return 0; }
+		}
+	}
+
+	// Wait for the last move to be made, the button is let go meanwhile so it is only made once. If nothing happens
+	// the move was blocked, so decide again.
+	getPlayerPosition(&x, &y, &d);
+	if ((solveWait > 0) && (x == solveX) && (y == solveY) && (d == solveD) && (solveWait < SOLVEWAIT))
+	{
+		solveWait++;
+		return 0;
+	}
+	solveX = x;
+	solveY = y;
+	solveD = d;
+	solveWait = 1;
+
+	move = solverMove(x, y, d);
+	if (move == 'l') { return VPAD_BUTTON_LEFT; }
+	if (move == 'r') { return VPAD_BUTTON_RIGHT; }
+	return VPAD_BUTTON_UP;
+}
+
+// Stand-in for reading the Wii U gamepad. The buttons were worked out for this tick before the game state was run.
+int32_t VPADRead(VPADChan chan, VPADStatus* buffers, uint32_t count, VPADReadError* error)
+{
+	memset(buffers, 0, sizeof(VPADStatus));
+	buffers->hold = padHold;
+	buffers->trigger = padHold & ~lastHold;
+	buffers->release = lastHold & ~padHold;
+	lastHold = padHold;
+	*error = VPAD_READ_SUCCESS;
+	return 1;
+}
+
+// Move the script on a tick, whether or not the game read the gamepad in it.
+static void nextTick(void)
+{
+	if (scriptStep >= scriptSteps) { return; }
+	stepTicks++;
+	if (stepTicks >= script[scriptStep].ticks)
+	{
+		scriptStep++;
+		stepTicks = 0;
+	}
+}
+
+// Read a script of gamepad input. Returns false if it can't be read.
+static bool readScript(const char* fileName)
+{
+	FILE* inFile = fopen(fileName, "rt");
+	char line[256];			// Line of the script.
+	char* word;				// Word in the line.
+	unsigned int lineNo = 0;
+	unsigned int i;
+
+	if (inFile == NULL) { fprintf(stderr, "Can't open %s\n", fileName); return false; }
+	script = malloc(MAXSTEPS * sizeof(struct step));
+	if (script == NULL) { fclose(inFile); fprintf(stderr, "Out of memory\n"); return false; }
+
+	while ((fgets(line, sizeof(line), inFile) != NULL) && (scriptSteps < MAXSTEPS))
+	{
+		lineNo++;
+		if (strchr(line, '#') != NULL) { *strchr(line, '#') = '\0'; }
+		word = strtok(line, " \t\r\n");
+		if (word == NULL) { continue; }
+
+		script[scriptSteps].ticks = (unsigned int)atoi(word);
+		script[scriptSteps].buttons = 0;
+		while ((word = strtok(NULL, " \t\r\n")) != NULL)
+		{
+			for (i = 0; i < sizeof(buttonNames) / sizeof(buttonNames[0]); i++)
+			{
+				if (strcmp(word, buttonNames[i].name) == 0) { break; }
+			}
+			if (i == sizeof(buttonNames) / sizeof(buttonNames[0]))
+			{
+				fprintf(stderr, "%s line %u: unknown button %s\n", fileName, lineNo, word);
+				fclose(inFile);
+				return false;
+			}
+			script[scriptSteps].buttons |= buttonNames[i].button;
+		}
+		if (script[scriptSteps].ticks > 0) { scriptSteps++; }
+	}
+	fclose(inFile);
+	return true;
+}
+
+// Get a file name that still works after changing directory, in name which has room for size characters.
+static const char* fullName(const char* fileName, char* name, size_t size)
+{
+	if (fileName[0] == '/') { return fileName; }
+	getcwd(name, size);
+	strncat(name, "/", size - strlen(name) - 1);
+	strncat(name, fileName, size - strlen(name) - 1);
+	return name;
+}
+
+// Make the directory the game keeps its level file in, wiiu/apps/Labyrinth under dir, and work from dir.
+static bool useDirectory(const char* dir)
+{
+	if (chdir(dir) != 0) { fprintf(stderr, "Can't use directory %s\n", dir); return false; }
+	mkdir("wiiu", 0777);
+	mkdir("wiiu/apps", 0777);
+	mkdir("wiiu/apps/Labyrinth", 0777);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned long ticks = 100000;		// Ticks to run.
+	const char* scriptName = NULL;		// Script to play.
+	unsigned int level = 1;				// Level to start from.
+	mazegen_t gen = GENBYLEVEL;			// Generator used.
+	mazemode_t shape = MODENORMAL;		// Maze shape played.
+	unsigned int seed = 1;				// Seed for the first maze.
+	unsigned int candidates = 1;		// Candidates each maze is picked from.
+	char tempDir[] = "/tmp/labyrinthXXXXXX";	// Directory made for the level file if none is given.
+	const char* dir = NULL;				// Directory the level file is kept in.
+	const char* recordName = NULL;		// Replay file to write.
+	const char* replayName = NULL;		// Replay file to play.
+	char name[1000];					// Replay file name from the directory started in.
+	bool started = false;				// Set once the replay has started.
+	bool keep = false;					// Set to carry on the level from the last run and keep it for the next.
+	bool memory = false;				// Set to keep the files in memory.
+	unsigned int state, lastState;		// Game state run this tick, and the one before.
+	unsigned long levels = 0;			// Levels completed.
+	const struct runrecord* last;		// Last level completed, from the run log.
+	unsigned long calls[STATES] = { 0 };	// Ticks run in each game state.
+	double stateMs[STATES] = { 0 }, maxMs[STATES] = { 0 };	// Total and longest time in each game state.
+	double start, took, total;
+	int opt;
+	static const char* stateNames[STATES] = { "doState0 (start)", "doState1 (playing)", "doState2 (new level)", "doState3 (end)" };
+
+	while ((opt = getopt(argc, argv, "t:s:l:g:m:S:c:ed:Mkw:r:")) != -1)
+	{
+		switch (opt)
+		{
+			case 't': { ticks = strtoul(optarg, NULL, 0); break; }
+			case 's': { scriptName = optarg; break; }
+			case 'l': { level = (unsigned int)atoi(optarg); break; }
+			case 'g': { gen = (mazegen_t)atoi(optarg); break; }
+			case 'm': { shape = (mazemode_t)atoi(optarg); break; }
+			case 'S': { seed = (unsigned int)strtoul(optarg, NULL, 0); break; }
+			case 'c': { candidates = (unsigned int)atoi(optarg); break; }
+			case 'e': { setEndless(true); break; }
+			case 'd': { dir = optarg; break; }
+			case 'M': { memory = true; break; }
+			case 'k': { keep = true; break; }
+			case 'w': { recordName = optarg; break; }
+			case 'r': { replayName = optarg; break; }
+			default:
+			{
+				fprintf(stderr, "Usage: %s [-t ticks] [-s script] [-l level] [-g generator] [-m mode] [-S seed] "
+					"[-c candidates] [-e] [-d dir | -M] [-k] [-w replay | -r replay]\n", argv[0]);
+				return 1;
+			}
+		}
+	}
+	if ((gen > GENBYLEVEL) || (shape >= MODECOUNT) || (level < 1)) { fprintf(stderr, "Bad level, generator or mode\n"); return 1; }
+	if ((recordName != NULL) && (replayName != NULL)) { fprintf(stderr, "Use one of -w and -r\n"); return 1; }
+	if ((memory == true) && ((dir != NULL) || (keep == true) || (recordName != NULL) || (replayName != NULL)))
+	{
+		fprintf(stderr, "-M can't be used with -d, -k, -w or -r\n");
+		return 1;
+	}
+	if ((scriptName != NULL) && (readScript(scriptName) == false)) { return 1; }
+	if (recordName != NULL) { setReplayFile(fullName(recordName, name, sizeof(name))); }
+	if (replayName != NULL)
+	{
+		setReplayFile(fullName(replayName, name, sizeof(name)));
+		replay = true;
+	}
+	if (memory == true) { startStorage(STORAGEMEMORY); }
+	else
+	{
+		if (dir == NULL)
+		{
+			dir = mkdtemp(tempDir);
+			if (dir == NULL) { fprintf(stderr, "Can't make a directory for the level file\n"); return 1; }
+		}
+		if (useDirectory(dir) == false) { return 1; }
+		startStorage(STORAGEFILES);
+	}
+	startRunLog();
+
+	// Set up the game the same way as main.c does on the Wii U.
+	if (keep == false) { writeLevel(level); }
+	readLevel();
+	setGenerator(gen);
+	setMode(shape);
+	setCandidates(candidates);
+	setSeed(seed);
+	if (keep == true) { resumePlay(); }
+
+	lastState = getGameState();
+	total = nowMs();
+	for (unsigned long t = 0; t < ticks; t++)
+	{
+		// The buttons come from the script, or the solver once the script has finished. This is done before the game
+		// state is timed, so the time the solver takes isn't counted as the game's.
+		if (scriptStep < scriptSteps) { padHold = script[scriptStep].buttons; }
+		else { padHold = solverButtons(); }
+
+		state = getGameState();
+		start = nowMs();
+		switch (state)
+		{
+			case 0: { doState0(); break; }
+			case 1: { doState1(); break; }
+			case 2: { doState2(); break; }
+			default: { doState3(); break; }
+		}
+		took = nowMs() - start;
+		logFrame((unsigned int)(took * 1000.0));
+
+		if (state >= STATES) { state = STATES - 1; }
+		calls[state]++;
+		stateMs[state] += took;
+		if (took > maxMs[state]) { maxMs[state] = took; }
+
+		// A level is completed when playing moves on to the new level or the end screen.
+		if ((lastState == 1) && ((getGameState() == 2) || (getGameState() == 3))) { levels++; }
+		lastState = getGameState();
+
+		nextTick();
+		clockTicks += OSMillisecondsToTicks(FRAMEMS);
+
+		// A replay is played once, stop when it is over.
+		if (isReplaying() == true) { started = true; }
+		else if ((replay == true) && (started == true)) { ticks = t + 1; break; }
+	}
+	total = nowMs() - total;
+	stopRecording();
+	if (keep == true) { suspendPlay(); }
+	stopMaze();
+
+	printf("%lu ticks in %.1f ms, %.0f ticks/sec (%.1fx the game speed)\n", ticks, total, ticks * 1000.0 / total,
+		(ticks * FRAMEMS) / total);
+	printf("%lu levels completed, %.2f levels/sec, now on level %u\n", levels, levels * 1000.0 / total, getLevel());
+	printf("%u levels in the run log", getRunCount());
+	last = getLastRun();
+	if (last != NULL)
+	{
+		printf(", level %u was the last completed in %u ms, the best time for it is %u ms", last->level, last->elapsed,
+			getBestTime(last->mode, last->gen, (last->flags & RUNENDLESS) != 0, last->level));
+	}
+	printf("\n");
+	if (replay == true)
+	{
+		if (started == false) { printf("Replay %s could not be played\n", replayName); }
+		else { printf("Replay completed %lu levels, %u when it was recorded\n", levels, getReplayLevels()); }
+	}
+	printf("%-22s %10s %12s %10s %10s\n", "state", "ticks", "total ms", "mean us", "max us");
+	for (unsigned int i = 0; i < STATES; i++)
+	{
+		printf("%-22s %10lu %12.1f %10.2f %10.1f\n", stateNames[i], calls[i], stateMs[i],
+			(calls[i] > 0) ? (stateMs[i] * 1000.0 / calls[i]) : 0.0, maxMs[i] * 1000.0);
+	}
+
+	// Tidy up the level file if it was put in a temporary directory.
+	if (dir == tempDir)
+	{
+		remove("wiiu/apps/Labyrinth/level.txt");
+		remove("wiiu/apps/Labyrinth/replay.lrp");
+		remove("wiiu/apps/Labyrinth/resume.bin");
+		remove("wiiu/apps/Labyrinth/runs.log");
+		remove("wiiu/apps/Labyrinth/runs.idx");
+		rmdir("wiiu/apps/Labyrinth");
+		rmdir("wiiu/apps");
+		rmdir("wiiu");
+		rmdir(tempDir);
+	}
+	free(script);
+	free(area);
+	free(cellFrom);
+	free(cellStamp);
+	free(queue);
+	free(tileStamp);
+
+	// A run that didn't complete a level, or a replay that didn't complete what it did when it was recorded, failed.
+	if (replay == true) { return ((started == true) && (levels == getReplayLevels())) ? 0 : 1; }
+	if (levels == 0) { fprintf(stderr, "No level was completed in %lu ticks\n", ticks); return 1; }
+	return 0;
+}
@@ -0,0 +1,436 @@
+// Check of the bit-packed maze layout for a Linux PC. Each maze is copied into a character for each cell, as the game
+// used to hold the maze in gameMaze[MMAX][MMAX], and the original get2DView, get3DView and movePlayer are run on the copy
+// next to the game's own. A walk round each maze makes the same moves in both, and every view around the player and
+// along the corridor must be the same after each move. The game makes its maze from the same seed, so this also checks
+// that the game and makeMaze make the same maze.
+//
+// With -m 1 it checks long corridor mode instead, where only the rows in the ring buffer can be seen. From the player it
+// searches every space that can be reached in the rows kept, and walks to the furthest row down, until it finds the exit.
+// It fails if the player ever can't get further down or can't reach the exit. With -m 2 it checks open world mode,
+// searching from where the player starts for the exit and walking to it, and fails if it can't be reached.
+//
+// Build from the top of the repository with:
+//   gcc -O2 -pthread -I source -o layoutcheck tools/layoutcheck.c source/Labyrinth.c source/Threads.c source/Bitboard.c source/Storage.c
+//
+// Usage: layoutcheck [-n count] [-l level] [-g generator] [-S seed] [-t moves] [-e] [-m mode]
+//   -n  Number of mazes to check, maze i is for level + i (default 25).
+//   -l  Level of the first maze (default 1).
+//   -g  Generator from enum MAZEGEN, 0 to 4, or 5 to choose from the level (default 5).
+//   -S  Seed for the first maze, maze i is made from seed + i (default 1).
+//   -t  Most moves made in each maze, the walk stops early if it finds the exit (default 20000).
+//   -e  Endless mode, so levels can go past MAXLEVEL.
+//   -m  Shape of maze checked from enum MAZEMODE, 0 checks the layout, 1 walks long corridors and 2 walks open worlds
+//       to their exits, which must be within 1024 cells of the start (default 0).
+
+#include <stdio.h>				// For printing.
+#include <stdlib.h>				// For atoi and memory.
+#include <stdint.h>				// For exact sized integers.
+#include <stdbool.h>			// For booleans.
+#include <string.h>				// For memset.
+#include <unistd.h>				// For getopt.
+
+#include "Labyrinth.h"			// For making and playing mazes.
+#include "Sounds.h"				// For the sound stub.
+#include "Storage.h"			// For keeping the level file in memory.
+
+#define VIEWRANGE  6			// Cells each way from the player compared with get2DView, more than the map shows.
+#define MAXREPORTS 10			// Differences printed before only counting them.
+#define SEARCHRANGE 1024		// Cells each way from the player searched for a way on, more than any maze is wide.
+#define SEARCHSIDE (SEARCHRANGE * 2)	// Cells along each side of the search area.
+#define TILESIDE   32			// Cells along each side of the tiles of the search area read from the game at once.
+#define TILES      (SEARCHSIDE / TILESIDE)	// Tiles along each side of the search area.
+
+// The maze as the game used to hold it, a character for each cell, with the player as the original code kept them.
+static char* gameMaze;			// Cells of the maze, row by row.
+static unsigned int Msize;		// Cells along each side.
+static unsigned int playerX;	// Player X position in gameMaze.
+static unsigned int playerY;	// Player Y position in gameMaze.
+static unsigned int playerD;	// Player facing 1=North(up), 2=East(right), 3=South(down), 4=West(left).
+
+// The area searched around the player, read from get2DView a tile at a time as the search reaches it.
+// Cells and tiles are only used when their stamp is the current search, so nothing needs clearing between searches.
+static char* area;				// Cells of the area, the player is at SEARCHRANGE, SEARCHRANGE.
+static unsigned int* tileStamp;	// Search each tile was last read for.
+static unsigned int* cellStamp;	// Search each cell was last reached in.
+static unsigned char* cellFrom;	// Direction the search reached each cell from.
+static unsigned int* queue;		// Search queue.
+static unsigned int stamp;		// Current search.
+
+// The game plays sounds when the player moves, but no sound is needed here.
+void putsoundSel(soundsel_t sndSel)
+{
+}
+
+// The original get3DView, on the character for each cell.
+static char oldGet3DView(int f, int s)
+{
+	unsigned int xi = 0;	// Working indices.
+	unsigned int yi = 0;
+
+	if ((f < 0) || (f > 8) || (s < -1) || (s > 1)) { return '#'; }
+	switch (playerD)
+	{
+		case 1:  { xi = (int)playerX + s; yi = (int)playerY - f; break; }
+		case 2:  { xi = (int)playerX + f; yi = (int)playerY + s; break; }
+		case 3:  { xi = (int)playerX - s; yi = (int)playerY + f; break; }
+		default: { xi = (int)playerX - f; yi = (int)playerY - s; break; }
+	}
+	if ((xi < Msize) && (yi < Msize)) { return gameMaze[(yi * Msize) + xi]; }
+	return '#';
+}
+
+// The original get2DView, on the character for each cell.
+static char oldGet2DView(int x, int y)
+{
+	unsigned int xi = (int)playerX + x;		// Working indices.
+	unsigned int yi = (int)playerY + y;
+
+	if ((xi < Msize) && (yi < Msize))
+	{
+		if ((y == 0) && (x == 0))
+		{
+			switch (playerD)
+			{
+				case 1:  { return '^'; }
+				case 2:  { return '>'; }
+				case 3:  { return '_'; }
+				default: { return '<'; }
+			}
+		}
+		return gameMaze[(yi * Msize) + xi];
+	}
+	return '#';
+}
+
+// The original movePlayer, on the character for each cell. The level isn't kept, the game's own is used.
+static unsigned int oldMovePlayer(char move)
+{
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for each direction.
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+	char next;			// Cell in front of the player.
+
+	if (move == 'l')
+	{
+		playerD = (playerD == 1) ? 4 : playerD - 1;
+		return 1;
+	}
+	if (move == 'r')
+	{
+		playerD = (playerD == 4) ? 1 : playerD + 1;
+		return 1;
+	}
+	if (move != 'f') { return 0; }
+
+	next = gameMaze[((playerY + dy[playerD]) * Msize) + playerX + dx[playerD]];
+	if (next == ' ')
+	{
+		playerX += dx[playerD];
+		playerY += dy[playerD];
+		return 1;
+	}
+	return (next == 'E') ? 2 : 0;
+}
+
+// Compare every view of the player's surroundings, printing the first few differences. Return the views compared.
+static unsigned long compareViews(unsigned int maze, unsigned int move, unsigned long* differences)
+{
+	unsigned long views = 0;	// Views compared.
+	char was, now;				// View from the original code and from the game.
+
+	for (int y = -VIEWRANGE; y <= VIEWRANGE; y++)
+	{
+		for (int x = -VIEWRANGE; x <= VIEWRANGE; x++)
+		{
+			was = oldGet2DView(x, y);
+			now = get2DView(x, y);
+			views++;
+			if (was == now) { continue; }
+			if (*differences < MAXREPORTS)
+			{
+				printf("maze %u move %u: get2DView(%d, %d) is '%c', was '%c'\n", maze, move, x, y, now, was);
+			}
+			(*differences)++;
+		}
+	}
+
+	// Include views just outside the range along the corridor, they must be blocks in both.
+	for (int f = -1; f <= 9; f++)
+	{
+		for (int s = -2; s <= 2; s++)
+		{
+			was = oldGet3DView(f, s);
+			now = get3DView(f, s);
+			views++;
+			if (was == now) { continue; }
+			if (*differences < MAXREPORTS)
+			{
+				printf("maze %u move %u: get3DView(%d, %d) is '%c', was '%c'\n", maze, move, f, s, now, was);
+			}
+			(*differences)++;
+		}
+	}
+	return views;
+}
+
+// Get a cell of the search area, reading its tile from the game the first time it is needed in a search.
+static char areaCell(unsigned int x, unsigned int y)
+{
+	unsigned int tile = ((y / TILESIDE) * TILES) + (x / TILESIDE);	// Tile the cell is in.
+	unsigned int tx = x - (x % TILESIDE), ty = y - (y % TILESIDE);	// Top left of the tile.
+
+	if (tileStamp[tile] != stamp)
+	{
+		for (unsigned int j = 0; j < TILESIDE; j++)
+		{
+			for (unsigned int i = 0; i < TILESIDE; i++)
+			{
+				area[((ty + j) * SEARCHSIDE) + tx + i] = get2DView((int)(tx + i) - SEARCHRANGE, (int)(ty + j) - SEARCHRANGE);
+			}
+		}
+		tileStamp[tile] = stamp;
+	}
+	return area[(y * SEARCHSIDE) + x];
+}
+
+// Search every space that can be reached from the player. Return the cell in the search area of the exit if it is found,
+// otherwise of the space furthest down, or UINT32_MAX if the search area couldn't be allocated.
+static unsigned int searchArea(void)
+{
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for each direction.
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+	unsigned int head = 0, tail = 0;	// Queue positions.
+	unsigned int c, n, x, y;			// Cell, next cell and its position.
+	unsigned int best;					// Space furthest down.
+	char cell;							// Next cell in the maze.
+
+	if (area == NULL)
+	{
+		area = malloc((size_t)SEARCHSIDE * SEARCHSIDE);
+		cellFrom = malloc((size_t)SEARCHSIDE * SEARCHSIDE);
+		cellStamp = calloc((size_t)SEARCHSIDE * SEARCHSIDE, sizeof(unsigned int));
+		queue = malloc((size_t)SEARCHSIDE * SEARCHSIDE * sizeof(unsigned int));
+		tileStamp = calloc((size_t)TILES * TILES, sizeof(unsigned int));
+		if ((area == NULL) || (cellFrom == NULL) || (cellStamp == NULL) || (queue == NULL) || (tileStamp == NULL))
+		{
+			return UINT32_MAX;
+		}
+	}
+	stamp++;
+
+	best = (SEARCHRANGE * SEARCHSIDE) + SEARCHRANGE;
+	cellStamp[best] = stamp;
+	queue[tail++] = best;
+	while (head < tail)
+	{
+		c = queue[head++];
+		if ((c / SEARCHSIDE) > (best / SEARCHSIDE)) { best = c; }
+		for (unsigned int d = 1; d <= 4; d++)
+		{
+			x = (c % SEARCHSIDE) + dx[d];
+			y = (c / SEARCHSIDE) + dy[d];
+			if ((x >= SEARCHSIDE) || (y >= SEARCHSIDE)) { continue; }
+			n = (y * SEARCHSIDE) + x;
+			if (cellStamp[n] == stamp) { continue; }
+			cell = areaCell(x, y);
+			if ((cell != ' ') && (cell != 'E')) { continue; }
+			cellStamp[n] = stamp;
+			cellFrom[n] = (unsigned char)d;
+			if (cell == 'E') { return n; }
+			queue[tail++] = n;
+		}
+	}
+	return best;
+}
+
+// Walk the player along the way the last search found to a cell of the search area. Return the result of the last
+// movePlayer, or 0 if a move was blocked. moves is the most steps that can be taken, and is reduced by the steps taken.
+static unsigned int walkTo(unsigned int c, unsigned int* moves)
+{
+	static const int dx[5] = { 0, 0, 1, 0, -1 };	// Steps for each direction.
+	static const int dy[5] = { 0, -1, 0, 1, 0 };
+	unsigned int start = (SEARCHRANGE * SEARCHSIDE) + SEARCHRANGE;	// Cell the player is in.
+	unsigned int steps = 0;		// Steps along the way.
+	unsigned int ret = 1;		// Result of the last move.
+	unsigned int d;				// Direction faced.
+
+	// Follow the way back to the player, keeping the directions at the end of the queue, which isn't needed any more.
+	while (c != start)
+	{
+		d = cellFrom[c];
+		queue[(SEARCHSIDE * SEARCHSIDE) - 1 - steps++] = d;
+		c = (unsigned int)((int)c - dx[d] - (dy[d] * SEARCHSIDE));
+	}
+
+	switch (get2DView(0, 0))
+	{
+		case '^': { d = 1; break; }
+		case '>': { d = 2; break; }
+		case '_': { d = 3; break; }
+		default:  { d = 4; break; }
+	}
+	while ((steps > 0) && (*moves > 0))
+	{
+		steps--;
+		(*moves)--;
+		while (d != queue[(SEARCHSIDE * SEARCHSIDE) - 1 - steps])
+		{
+			if (((d % 4) + 1) == queue[(SEARCHSIDE * SEARCHSIDE) - 1 - steps]) { movePlayer('r'); d = (d % 4) + 1; }
+			else { movePlayer('l'); d = (d == 1) ? 4 : d - 1; }
+		}
+		ret = movePlayer('f');
+		if (ret != 1) { break; }
+	}
+	return ret;
+}
+
+// Walk the player through a maze that is only partly in memory until the exit is found. Long corridors are walked to the
+// space furthest down that can be reached until the exit can be seen, open worlds are searched from the start for the
+// exit. Return true if the exit was reached, printing why if it wasn't.
+static bool walkToExit(mazemode_t mode, unsigned int maze, unsigned int moves, unsigned long* made)
+{
+	unsigned int c;				// Cell the search found.
+	unsigned int ret;			// Result of the walk.
+	unsigned int left = moves;	// Steps left to take.
+
+	while (left > 0)
+	{
+		c = searchArea();
+		if (c == UINT32_MAX) { printf("Out of memory\n"); return false; }
+		if ((area[c] != 'E') && (mode == MODEWORLD))
+		{
+			printf("maze %u: exit can't be reached within %u cells of the start\n", maze, SEARCHRANGE);
+			return false;
+		}
+		if ((area[c] != 'E') && ((c / SEARCHSIDE) <= SEARCHRANGE))
+		{
+			printf("maze %u: shut in, no way further down after %u steps\n", maze, moves - left);
+			return false;
+		}
+		ret = walkTo(c, &left);
+		if (ret == 2) { *made += moves - left; return true; }
+		if (ret == 0)
+		{
+			printf("maze %u: blocked walking the way the search found after %u steps\n", maze, moves - left);
+			return false;
+		}
+	}
+	printf("maze %u: exit not found in %u steps\n", maze, moves);
+	*made += moves;
+	return false;
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int count = 25;			// Mazes to check.
+	unsigned int level = 1;				// Level of the first maze.
+	mazegen_t gen = GENBYLEVEL;			// Generator used.
+	uint32_t seed = 1;					// Seed of the first maze.
+	unsigned int moves = 20000;			// Most moves in each maze.
+	struct maze* m;						// Maze copied for the original code.
+	uint32_t walk = 0x9E3779B9u;		// Random numbers for the walk.
+	char move;							// Move made.
+	unsigned int was, now;				// Result of the move from the original code and from the game.
+	unsigned long made = 0;				// Moves made in every maze.
+	unsigned long views = 0;			// Views compared.
+	unsigned long differences = 0;		// Views and moves that weren't the same.
+	unsigned int exits = 0;				// Mazes where the walk found the exit.
+	mazemode_t mode = MODENORMAL;		// Shape of maze checked.
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:l:g:S:t:em:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n': { count = (unsigned int)atoi(optarg); break; }
+			case 'l': { level = (unsigned int)atoi(optarg); break; }
+			case 'g': { gen = (mazegen_t)atoi(optarg); break; }
+			case 'S': { seed = (uint32_t)strtoul(optarg, NULL, 0); break; }
+			case 't': { moves = (unsigned int)atoi(optarg); break; }
+			case 'e': { setEndless(true); break; }
+			case 'm': { mode = (mazemode_t)atoi(optarg); break; }
+			default:
+			{
+				fprintf(stderr, "Usage: %s [-n count] [-l level] [-g generator] [-S seed] [-t moves] [-e] [-m mode]\n",
+					argv[0]);
+				return 2;
+			}
+		}
+	}
+	if ((level < 1) || (gen > GENBYLEVEL) || (mode >= MODECOUNT)) { fprintf(stderr, "Bad level, generator or mode\n"); return 2; }
+
+	startStorage(STORAGEMEMORY);		// The game saves the level as each maze is finished, keep it off the disk.
+	setGenerator(gen);
+	setMode(mode);
+
+	// Shapes other than the normal maze are walked to the exit through the part of the maze the game keeps.
+	if (mode != MODENORMAL)
+	{
+		for (unsigned int i = 0; i < count; i++)
+		{
+			writeLevel(level + i);
+			setSeed(seed + i);
+			generateMaze();
+			if (walkToExit(mode, i, moves, &made) == true) { exits++; }
+		}
+		stopMaze();
+		printf("%u mazes, %lu steps, %u exits reached\n", count, made, exits);
+		return (exits == count) ? 0 : 1;
+	}
+
+	m = newMaze();
+	if (m == NULL) { fprintf(stderr, "Out of memory\n"); return 1; }
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		// The game's maze for the level.
+		writeLevel(level + i);
+		setSeed(seed + i);
+		generateMaze();
+
+		// The same maze copied to a character for each cell, with the player where the game starts them.
+		makeMaze(m, getLevel(), seed + i, gen);
+		Msize = getMazeSize(m);
+		gameMaze = realloc(gameMaze, (size_t)Msize * Msize);
+		if (gameMaze == NULL) { fprintf(stderr, "Out of memory\n"); return 1; }
+		for (unsigned int y = 0; y < Msize; y++)
+		{
+			for (unsigned int x = 0; x < Msize; x++) { gameMaze[(y * Msize) + x] = getMazeCell(m, x, y); }
+		}
+		getMazeStart(m, &playerX, &playerY);
+		playerD = 2;
+		views += compareViews(i, 0, &differences);
+
+		// Walk round the maze, mostly going forward where it can and turning at random otherwise.
+		for (unsigned int j = 1; j <= moves; j++)
+		{
+			walk ^= walk << 13;
+			walk ^= walk >> 17;
+			walk ^= walk << 5;
+			if ((oldGet3DView(1, 0) != '#') && ((walk % 4) != 0)) { move = 'f'; }
+			else { move = ((walk >> 8) & 1) ? 'l' : 'r'; }
+
+			was = oldMovePlayer(move);
+			now = movePlayer(move);
+			made++;
+			if (was != now)
+			{
+				if (differences < MAXREPORTS) { printf("maze %u move %u: movePlayer('%c') is %u, was %u\n", i, j, move, now, was); }
+				differences++;
+				break;
+			}
+			if (now == 2)
+			{
+				exits++;
+				break;
+			}
+			views += compareViews(i, j, &differences);
+		}
+	}
+	stopMaze();
+
+	printf("%u mazes, %lu moves, %u exits found, %lu views compared, %lu differences\n", count, made, exits, views,
+		differences);
+	free(gameMaze);
+	freeMaze(m);
+	return (differences == 0) ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+// Batch maze generator for a Linux PC. Makes lots of mazes for one level across all cores, checks each one,
+// and writes statistics for every maze, so levels can be made and checked offline and generator speed can be tracked.
+//
+// Build from the top of the repository with:
+//   gcc -O2 -pthread -I source -o mazebatch tools/mazebatch.c source/Labyrinth.c source/Threads.c source/Bitboard.c source/Storage.c
+//
+// Usage: mazebatch [-n count] [-l level | -s blocks] [-r] [-g generator] [-e path] [-S seed] [-j threads] [-o dir] [-m]
+//                  [-p pack]
+//   -n  Number of mazes to make (default 1000).
+//   -l  Level to make the mazes for (default 25), or -s for the number of building blocks along each side.
+//   -r  Make a range of levels, maze i is for level + i. Use -l 1 -n 25 -r -p levels.lab to make a pack for the game.
+//   -g  Generator from enum MAZEGEN, 0 to 4, or 5 to choose from the level (default 0).
+//   -e  Moves wanted from the start to the exit, the exit goes at the dead end nearest to this (default 0, the furthest).
+//   -S  Seed for the first maze, maze i is made from seed + i (default 1). Any maze can be played with its seed.
+//   -j  Number of worker threads (default one per core).
+//   -o  Directory to write the results to (default the current directory).
+//   -m  Also write each maze as a text file, as twoDdisplay shows it.
+//   -p  Also write all the mazes to a .lab pack file, in the -o directory unless the name has a '/' in it, in which case it
+//       is used as given. Every maze is kept in memory until the end.
+
+#include <stdio.h>				// For printing and files.
+#include <stdlib.h>				// For atoi and memory.
+#include <stdint.h>				// For exact sized integers.
+#include <stdbool.h>			// For booleans.
+#include <stdatomic.h>			// For the work queue counter.
+#include <string.h>				// For memset.
+#include <time.h>				// For timing.
+#include <unistd.h>				// For getopt and the number of cores.
+
+#include "Labyrinth.h"			// For making mazes.
+#include "Sounds.h"				// For the sound stub.
+#include "Threads.h"			// For the worker threads.
+
+#define MAXTHREADS 64			// Most worker threads used.
+#define MAZEADD    4			// Blocks added to the level for the maze size, as in Labyrinth.c.
+
+// Statistics for one maze.
+struct result
+{
+	uint32_t seed;				// Seed the maze was made from.
+	unsigned int level;			// Level the maze is for.
+	unsigned int cells;			// Cells along each side of the maze.
+	double genMs;				// Time to make the maze in milliseconds.
+	unsigned int open;			// Spaces in the maze.
+	unsigned int reached;		// Spaces that can be reached from the start.
+	unsigned int deadEnds;		// Spaces with only one space next to them, the exit's dead end is still a dead end.
+	unsigned int junctions;		// Spaces with three or more ways out.
+	unsigned int path;			// Moves from the start to the exit, 0 if it can't be reached.
+	struct mazestats stats;		// Measures of the maze from the maze code, to check against.
+	bool valid;					// Exit can be reached and every space can be reached.
+};
+
+// Settings for the batch, shared by all the workers.
+static unsigned int count = 1000;		// Mazes to make.
+static unsigned int level = 25;			// Level the mazes are for.
+static mazegen_t gen = GENBLOCKS;		// Generator used.
+static uint32_t seed = 1;				// Seed of the first maze.
+static const char* outDir = ".";		// Directory for the results.
+static bool writeMazes = false;			// Write each maze as text.
+static bool range = false;				// Maze i is for level + i.
+static const char* packName = NULL;		// Pack file to write, NULL for none.
+static struct maze** packMazes = NULL;	// Every maze, kept to write the pack.
+
+static atomic_uint nextMaze;			// Work queue, the next maze to be made.
+static struct result* results;			// Statistics for each maze, in maze order.
+
+// The game plays sounds when the player moves, but no sound is needed here.
+void putsoundSel(soundsel_t sndSel)
+{
+}
+
+// Get a time in milliseconds.
+static double nowMs(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (t.tv_sec * 1000.0) + (t.tv_nsec / 1000000.0);
+}
+
+// Check a maze with a breadth first search from the start, filling in the statistics.
+// dist and queue must each have room for every cell.
+static void checkMaze(struct maze* m, struct result* r, unsigned int* dist, unsigned int* queue)
+{
+	unsigned int size = getMazeSize(m);	// Cells along each side.
+	unsigned int head = 0, tail = 0;	// Queue positions.
+	unsigned int x, y, c, n, ways;		// Cell position, cell, next cell and ways out of a cell.
+	static const int dx[4] = { 0, 1, 0, -1 };
+	static const int dy[4] = { -1, 0, 1, 0 };
+
+	memset(dist, 0xFF, (size_t)size * size * sizeof(unsigned int));
+	getMazeStart(m, &x, &y);
+	dist[(y * size) + x] = 0;
+	queue[tail++] = (y * size) + x;
+
+	while (head < tail)
+	{
+		c = queue[head++];
+		x = c % size;
+		y = c / size;
+		r->reached++;
+
+		for (unsigned int d = 0; d < 4; d++)
+		{
+			n = c + (dy[d] * (int)size) + dx[d];
+			switch (getMazeCell(m, x + dx[d], y + dy[d]))
+			{
+				case 'E':
+				{
+					if (r->path == 0) { r->path = dist[c] + 1; }
+					break;
+				}
+				case ' ':
+				{
+					if (dist[n] == UINT32_MAX)
+					{
+						dist[n] = dist[c] + 1;
+						queue[tail++] = n;
+					}
+					break;
+				}
+				default: { break; }
+			}
+		}
+	}
+
+	// Count every space, and how many ways out each one has.
+	for (y = 0; y < size; y++)
+	{
+		for (x = 0; x < size; x++)
+		{
+			if (getMazeCell(m, x, y) != ' ') { continue; }
+			r->open++;
+			ways = 0;
+			for (unsigned int d = 0; d < 4; d++)
+			{
+				if (getMazeCell(m, x + dx[d], y + dy[d]) == ' ') { ways++; }
+			}
+			if (ways == 1) { r->deadEnds++; }
+			if (ways >= 3) { r->junctions++; }
+		}
+	}
+	r->valid = (r->path != 0) && (r->reached == r->open);
+}
+
+// Write a maze as text, one line for each row.
+static void saveMaze(struct maze* m, unsigned int i)
+{
+	char fileName[1000];	// Name of the maze file.
+	FILE* outFile;
+	unsigned int size = getMazeSize(m);
+
+	snprintf(fileName, sizeof(fileName), "%s/maze_%05u.txt", outDir, i);
+	outFile = fopen(fileName, "wt");
+	if (outFile == NULL) { return; }
+	for (unsigned int y = 0; y < size; y++)
+	{
+		for (unsigned int x = 0; x < size; x++) { fputc(getMazeCell(m, x, y), outFile); }
+		fputc('\n', outFile);
+	}
+	fclose(outFile);
+}
+
+// Worker thread, taking mazes from the work queue until there are none left.
+static void worker(void* arg)
+{
+	struct maze* m = (packName == NULL) ? newMaze() : NULL;	// Maze re-used for each maze made by this worker.
+	unsigned int* dist = NULL;			// Distance of each cell from the start.
+	unsigned int* queue = NULL;			// Search queue.
+	size_t cells = 0;					// Cells the search memory has room for.
+	unsigned int i;						// Maze being made.
+	double start;						// Time the maze was started.
+
+	for (i = atomic_fetch_add(&nextMaze, 1); i < count; i = atomic_fetch_add(&nextMaze, 1))
+	{
+		// When making a pack every maze is kept, otherwise the one maze is re-used.
+		if (packName != NULL)
+		{
+			m = newMaze();
+			packMazes[i] = m;
+		}
+		if (m == NULL) { continue; }
+
+		results[i].level = (range == true) ? level + i : level;
+		start = nowMs();
+		makeMaze(m, results[i].level, seed + i, gen);
+		results[i].genMs = nowMs() - start;
+		results[i].seed = seed + i;
+		results[i].cells = getMazeSize(m);
+
+		if ((size_t)results[i].cells * results[i].cells > cells)
+		{
+			cells = (size_t)results[i].cells * results[i].cells;
+			free(dist);
+			free(queue);
+			dist = malloc(cells * sizeof(unsigned int));
+			queue = malloc(cells * sizeof(unsigned int));
+			if ((dist == NULL) || (queue == NULL)) { cells = 0; continue; }
+		}
+		checkMaze(m, &results[i], dist, queue);
+		getMazeStats(m, &results[i].stats);
+		if (writeMazes == true) { saveMaze(m, i); }
+	}
+	free(dist);
+	free(queue);
+	if (packName == NULL) { freeMaze(m); }
+}
+
+int main(int argc, char** argv)
+{
+	struct thread threads[MAXTHREADS];	// Worker threads.
+	unsigned int nthreads;				// Number of worker threads.
+	unsigned int started = 0;			// Worker threads started.
+	unsigned int valid = 0;				// Mazes that passed the checks.
+	double cellsMade = 0;				// Cells in all the mazes.
+	double start, took;					// Time for the whole batch.
+	char fileName[1000];				// Name of the statistics file.
+	FILE* outFile;
+	int opt;
+
+	nthreads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	while ((opt = getopt(argc, argv, "n:l:s:rg:e:S:j:o:mp:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'n': { count = (unsigned int)atoi(optarg); break; }
+			case 'l': { level = (unsigned int)atoi(optarg); break; }
+			case 's': { level = ((unsigned int)atoi(optarg) > MAZEADD) ? (unsigned int)atoi(optarg) - MAZEADD : 1; break; }
+			case 'g': { gen = (mazegen_t)atoi(optarg); break; }
+			case 'e': { setExitPath((unsigned int)atoi(optarg)); break; }
+			case 'S': { seed = (uint32_t)strtoul(optarg, NULL, 0); break; }
+			case 'j': { nthreads = (unsigned int)atoi(optarg); break; }
+			case 'o': { outDir = optarg; break; }
+			case 'm': { writeMazes = true; break; }
+			case 'r': { range = true; break; }
+			case 'p': { packName = optarg; break; }
+			default:
+			{
+				fprintf(stderr, "Usage: %s [-n count] [-l level | -s blocks] [-r] [-g generator] [-e path] [-S seed] [-j threads] [-o dir] [-m] [-p pack]\n", argv[0]);
+				return 2;
+			}
+		}
+	}
+	if (nthreads < 1) { nthreads = 1; }
+	if (nthreads > MAXTHREADS) { nthreads = MAXTHREADS; }
+	if (gen > GENBYLEVEL) { gen = GENBLOCKS; }
+
+	results = calloc(count, sizeof(struct result));
+	if (packName != NULL) { packMazes = calloc(count, sizeof(struct maze*)); }
+	if (((results == NULL) || ((packName != NULL) && (packMazes == NULL))) && (count > 0))
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	// Start the workers, they share out the mazes between them.
+	atomic_store(&nextMaze, 0);
+	start = nowMs();
+	for (unsigned int t = 0; t < nthreads; t++)
+	{
+		if (startThread(&threads[started], worker, NULL, t) == true) { started++; }
+	}
+	if (started == 0) { worker(NULL); }
+	for (unsigned int t = 0; t < started; t++) { joinThread(&threads[t]); }
+	took = nowMs() - start;
+
+	// Write the statistics for every maze.
+	snprintf(fileName, sizeof(fileName), "%s/stats.csv", outDir);
+	outFile = fopen(fileName, "wt");
+	if (outFile == NULL) { fprintf(stderr, "Can't write %s\n", fileName); return 1; }
+	fprintf(outFile, "maze,seed,level,generator,cells,gen_ms,open,reached,dead_ends,junctions,path,valid,corridor,branching,winding,repairs\n");
+	for (unsigned int i = 0; i < count; i++)
+	{
+		struct result* r = &results[i];
+		// The maze code's own measures must agree with the check.
+		if ((r->stats.path != r->path) || (r->stats.spaces != r->reached) || (r->stats.deadEnds != r->deadEnds) ||
+			(r->stats.junctions != r->junctions))
+		{
+			r->valid = false;
+		}
+		fprintf(outFile, "%u,%u,%u,%s,%u,%.3f,%u,%u,%u,%u,%u,%d,%.2f,%.2f,%.2f,%u\n", i, r->seed, r->level,
+			getGeneratorName((gen < GENCOUNT) ? gen : (r->level - 1) % GENCOUNT), r->cells, r->genMs,
+			r->open, r->reached, r->deadEnds, r->junctions, r->path, r->valid ? 1 : 0,
+			r->stats.corridor, r->stats.branching, (r->cells > 0) ? (double)r->path / r->cells : 0.0, r->stats.repairs);
+		if (r->valid == true) { valid++; }
+		cellsMade += (double)r->cells * r->cells;
+	}
+	fclose(outFile);
+
+	// Write every maze to the pack, savePack puts them in level order. A pack name with a path in it is used as given.
+	if (packName != NULL)
+	{
+		if (strchr(packName, '/') != NULL) { snprintf(fileName, sizeof(fileName), "%s", packName); }
+		else { snprintf(fileName, sizeof(fileName), "%s/%s", outDir, packName); }
+		for (unsigned int i = 0; i < count; i++)
+		{
+			if (packMazes[i] == NULL) { fprintf(stderr, "Out of memory\n"); return 1; }
+		}
+		if (savePack(fileName, packMazes, count) == false) { fprintf(stderr, "Can't write %s\n", fileName); return 1; }
+		for (unsigned int i = 0; i < count; i++) { freeMaze(packMazes[i]); }
+	}
+
+	printf("%u mazes, level %u, %s, %u threads\n", count, level,
+		getGeneratorName((gen < GENCOUNT) ? gen : (level - 1) % GENCOUNT), started ? started : 1);
+	printf("%u valid, %u failed\n", valid, count - valid);
+	printf("%.1f ms, %.1f mazes/sec, %.0f cells/sec\n", took, count / (took / 1000.0), cellsMade / (took / 1000.0));
+	return (valid == count) ? 0 : 1;
+}